@@ -1,305 +1,1362 @@
-/*
-
-File name: gtimer.c
-Target: portable
-Purpose: Manager of soft timers
-
-*/
-
-#define _TIMER_IMPLEMENTATION
-
-/****************************************************************************/
-/*                                                                          */
-/*                  MODULE DEPENDENCY                                       */
-/*                                                                          */
-/****************************************************************************/
-
-#include "gtimer.h"
-
-/****************************************************************************/
-/*                                                                          */
-/*                  DEFINITIONS AND MACROS                                  */
-/*                                                                          */
-/***************************************************************************/
-
-#define TIMER_COUNT_VALUE   ((GTIMER_TICK_MS)*(OSC_FREQUENCY) / (1000))
-
-typedef struct
-{
- byte req : 1;                         // in use or not
- byte running : 1;                     // started or not
- byte timeout : 1;                     // reached a timeout
- byte bAuto : 1;                       // auto-reload or not
- dword count;                          // periods of GTIMER_TICK_MS to run before time out
- dword count0;                         // reload value
-#ifdef GTIMER_IMPLEMENTS_CALLBACK
- gtimerCallbackPtr pCallback;          // function to call when timer expires
- dword inValue;                        // its 'in' parameter
- dword* pOutValue;                     // reference to its 'out' parameter
-#endif
-}
-TimerType;
-
-/****************************************************************************/
-/*                                                                          */
-/*                  PROTOTYPES OF NOT EXPORTED FUNCTIONS                    */
-/*                                                                          */
-/****************************************************************************/
-
-static void init_Timer(byte id);
-
-/****************************************************************************/
-/*                                                                          */
-/*                  EXPORTED / IMPORTED GLOBAL VARIABLES                    */
-/*                                                                          */
-/****************************************************************************/
-
-volatile boolean bTimerInterruptFired; // true when the interrupt triggered and further process is needed
-
-/****************************************************************************/
-/*                                                                          */
-/*                  NOT EXPORTED GLOBAL VARIABLES                           */
-/*                                                                          */
-/****************************************************************************/
-
-/* array of gTimers */
-static TimerType Timer[_N_GTIMERS];
-
-/****************************************************************************/
-/*                                                                          */
-/*                  EXPORTED FUNCTIONS                                      */
-/*                                                                          */
-/****************************************************************************/
-
-/****************************************************************************/
-void gtimerInitModule(void)
-/****************************************************************************/
-{
- byte id;
-
- for (id = 0; id < _N_GTIMERS; id++)
-  {
-   init_Timer(id);
-  }
-}
-
-/****************************************************************************/
-byte gtimerRequest(void)
-/****************************************************************************/
-{
- byte id;
-
- for (id = 0; id < _N_GTIMERS; id++)
-  {
-   if (!Timer[id].req)
-    {
-     Timer[id].req = TRUE;
-     break;
-    }
-  }
-
- return id;
-}
-
-/****************************************************************************/
-byte gtimerReserve(byte id)
-/****************************************************************************/
-{
- if (id >= _N_GTIMERS)
-  {
-   return _N_GTIMERS;
-  }
-
- if (Timer[id].req)
-  {
-   return _N_GTIMERS;
-  }
-
- Timer[id].req = TRUE;
-
- return id;
-}
-
-/****************************************************************************/
-byte gtimerRelease(byte id)
-/****************************************************************************/
-{
- if (id >= _N_GTIMERS)
-  {
-   return _N_GTIMERS;
-  }
-
- init_Timer(id);
-
- return id;
-}
-
-/****************************************************************************/
-void gtimerInitAndStart(byte id, dword count, boolean bAuto)
-/****************************************************************************/
-{
- if (Timer[id].req == FALSE)
-  {
-   return;
-  }
- if (count < 2)
-  {
-   count = 2;
-  }
- Timer[id].count = count;                 // set count value
- Timer[id].count0 = count;                // set reload value
- Timer[id].bAuto = bAuto;                 // auto restarts at timeout
- Timer[id].timeout = FALSE;               // clears timeout condition
- Timer[id].running = TRUE;                // start timer
-}
-
-/****************************************************************************/
-void gtimerRestart(byte id)
-/****************************************************************************/
-{
- gtimerInitAndStart(id, Timer[id].count0, Timer[id].bAuto);
-}
-
-/****************************************************************************/
-void gtimerFreeze(byte id)
-/****************************************************************************/
-{
- Timer[id].running = FALSE;                   // stop running
-}
-
-/****************************************************************************/
-void gtimerResume(byte id)
-/****************************************************************************/
-{
- if (Timer[id].req != FALSE || (Timer[id].bAuto == FALSE && Timer[id].timeout))
-  {
-   Timer[id].running = TRUE;    // start timer with last count
-  }
-}
-
-/****************************************************************************/
-void gtimerFastForward(byte id)
-/****************************************************************************/
-{
- if (Timer[id].req != FALSE || Timer[id].running != FALSE)
-  {
-   Timer[id].count = 1;
-  }
-}
-
-/****************************************************************************/
-boolean gtimerRunning(byte id)
-/****************************************************************************/
-{
- return Timer[id].running;
-}
-
-/****************************************************************************/
-boolean gtimerTO(byte id)
-/****************************************************************************/
-{
- boolean bRet = Timer[id].timeout;
- if (Timer[id].bAuto)
-  {
-   Timer[id].timeout = FALSE;
-  }
- return bRet;
-}
-
-/****************************************************************************/
-dword gtimerGetTimeToGo(byte id)
-/****************************************************************************/
-{
- return Timer[id].count;
-}
-
-#ifdef GTIMER_IMPLEMENTS_CALLBACK
-/****************************************************************************/
-void gtimerSetCallback(byte id, gtimerCallbackPtr pCallback, dword inValue, dword* pOutValue)
-/****************************************************************************/
-{
- Timer[id].pCallback = pCallback;
- Timer[id].inValue = inValue;
- Timer[id].pOutValue = pOutValue;
-}
-
-/****************************************************************************/
-void gtimerSetCallbackInput(byte id, dword inValue)
-/****************************************************************************/
-{
- Timer[id].inValue = inValue;
-}
-
-/****************************************************************************/
-void gtimerClearCallback(byte id)
-/****************************************************************************/
-{
- Timer[id].pCallback = NULL;
- Timer[id].inValue = 0;
- Timer[id].pOutValue = NULL;
-}
-#endif
-
-/****************************************************************************/
-/*                                                                          */
-/*                  NOT EXPORTED FUNCTIONS                                  */
-/*                                                                          */
-/****************************************************************************/
-
-/****************************************************************************/
-static void init_Timer(byte id)
-/****************************************************************************/
-{
- TimerType* pTimer = Timer + id;
-
- pTimer->req = FALSE;
- pTimer->count = 0;
- pTimer->count0 = 0;
- pTimer->running = FALSE;
- pTimer->bAuto = FALSE;
- pTimer->running = FALSE;
-#ifdef IMPLEMENTS_TIMER_CALL_BACK
- gtimerClearCallback(id);
-#endif
-
-}
-
-/****************************************************************************/
-void gtimerOnTick(void)
-/****************************************************************************/
-{
- byte id;
- TimerType* pTimer = Timer;
-
- bTimerInterruptFired = FALSE;
-
- for (id = 0; id < _N_GTIMERS; id++, pTimer++)
-  {
-   if (pTimer->running && pTimer->count > 0)
-    {
-     pTimer->count--;
-     if (pTimer->count == 0)
-      {
-       pTimer->timeout = TRUE;
-       if (pTimer->bAuto)
-        {
-         pTimer->count = pTimer->count0;
-        }
-       else
-        {
-         pTimer->running = FALSE;
-        }
-    #ifdef GTIMER_IMPLEMENTS_CALLBACK
-       if (pTimer->pCallback != NULL)
-        {
-         dword outValue = pTimer->pCallback(id, pTimer->inValue);
-         if (pTimer->pOutValue != NULL)
-          {
-           *pTimer->pOutValue = outValue;
-          }
-        }
-    #endif
-      }
-    }
-  }
-}
+/*
+
+File name: gtimer.c
+Target: portable
+Purpose: Manager of soft timers
+
+*/
+
+#if defined(GTIMER_IMPLEMENTS_NS) && !defined(_POSIX_C_SOURCE)
+ #define _POSIX_C_SOURCE 200112L   /* clock_gettime, clock_nanosleep and CLOCK_MONOTONIC, even with -std=c99 */
+#endif
+
+#define _TIMER_IMPLEMENTATION
+
+/****************************************************************************/
+/*                                                                          */
+/*                  MODULE DEPENDENCY                                       */
+/*                                                                          */
+/****************************************************************************/
+
+#include "gtimer.h"
+#ifdef GTIMER_IMPLEMENTS_NS
+ #include <errno.h>
+ #include <time.h>
+#endif
+#ifdef GTIMER_IMPLEMENTS_TRACE
+ #include "trace.h"
+#endif
+
+/****************************************************************************/
+/*                                                                          */
+/*                  DEFINITIONS AND MACROS                                  */
+/*                                                                          */
+/***************************************************************************/
+
+#define TIMER_COUNT_VALUE   ((GTIMER_TICK_MS)*(OSC_FREQUENCY) / (1000))
+
+#ifndef __GNUC__
+ #ifndef GTIMER_ENTER_CRITICAL /* should mask the tick interrupt */
+  #define GTIMER_ENTER_CRITICAL()
+  #define GTIMER_EXIT_CRITICAL()
+ #endif
+#endif
+
+#define DWORD_BITS (8 * sizeof(dword))
+
+/* ticks of the API of the default pool to its own time unit and back (rounded up) */
+#ifdef GTIMER_IMPLEMENTS_NS
+ #define TICKS_TO_POOL(ticks) ((dword)(ticks) * GTIMER_NS_PER_TICK)
+ #define POOL_TO_TICKS(units) (((units) + GTIMER_NS_PER_TICK - 1) / GTIMER_NS_PER_TICK)
+#else
+ #define TICKS_TO_POOL(ticks) (ticks)
+ #define POOL_TO_TICKS(units) (units)
+#endif
+
+/* a nanosecond pool brings its tick count to the clock before a delay is started or read */
+#ifdef GTIMER_IMPLEMENTS_NS
+ #define CATCH_UP(This) catch_Up(This)
+#else
+ #define CATCH_UP(This)
+#endif
+
+/* events of a timer in the trace ring */
+#ifdef GTIMER_IMPLEMENTS_TRACE
+ #define TRACE(event, id) traceRecord(event, 0, (word)(id))
+#else
+ #define TRACE(event, id)
+#endif
+
+/* one bit per timer bitmaps */
+#define BIT_TEST(map, id) (((map)[(id) / DWORD_BITS] >> ((id) % DWORD_BITS)) & 1)
+#define BIT_SET(map, id) ((map)[(id) / DWORD_BITS] |= (dword)1 << ((id) % DWORD_BITS))
+#define BIT_CLEAR(map, id) ((map)[(id) / DWORD_BITS] &= ~((dword)1 << ((id) % DWORD_BITS)))
+#define BIT_WRITE(map, id, b) ((b) ? BIT_SET(map, id) : BIT_CLEAR(map, id))
+
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+/* timing wheel: each level splits expiry ticks in 2^GTIMER_WHEEL_SLOT_BITS slots
+   a pending timer lives on the level of the highest bit where its expiry differs from tick count,
+   in the slot given by the bits of its expiry on this level: as a result a level-0 slot only holds timers
+   timing out on one single tick and any timer of a level expires before any timer of an upper level
+   timers whose expiry wrapped around the tick counter wait in an extra overflow slot */
+ #define WHEEL_SLOT_MASK (GTIMER_WHEEL_SLOTS - 1)
+#endif
+
+/****************************************************************************/
+/*                                                                          */
+/*                  PROTOTYPES OF NOT EXPORTED FUNCTIONS                    */
+/*                                                                          */
+/****************************************************************************/
+
+static void* carve_Storage(byte** ppStorage, dword size);
+#ifdef GTIMER_IMPLEMENTS_NS
+static dword monotonic_Ns(void);
+static void catch_Up(gtimerPoolT* This);
+#endif
+static void init_Timer(gtimerPoolT* This, gtimerIdT id);
+static void arm_Timer(gtimerPoolT* This, gtimerIdT id, dword count);
+static void disarm_Timer(gtimerPoolT* This, gtimerIdT id);
+static void expire_Timer(gtimerPoolT* This, gtimerIdT id);
+static dword next_Expiry(gtimerPoolT* This);
+static void skip_Ticks(gtimerPoolT* This, dword ticks);
+static void process_Tick(gtimerPoolT* This);
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+static void run_Callback(gtimerPoolT* This, gtimerIdT id, dword inValue, boolean bRearm);
+#endif
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+static void drop_Events(gtimerPoolT* This, gtimerIdT id);
+#endif
+#ifdef GTIMER_IMPLEMENTS_STATS
+static void count_InHistogram(dword* histogram, dword value);
+#endif
+static unsigned lowest_BitSet(dword value);
+#if defined(GTIMER_IMPLEMENTS_STATS) || defined(GTIMER_IMPLEMENTS_SLACK)
+static unsigned highest_BitSet(dword value);
+#endif
+#ifdef GTIMER_IMPLEMENTS_SLACK
+static dword slack_Expiry(const gtimerPoolT* This, gtimerIdT id);
+#endif
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+static unsigned wheel_SlotOf(const gtimerPoolT* This, dword expiry);
+static void wheel_Link(gtimerPoolT* This, gtimerIdT id);
+static void wheel_Unlink(gtimerPoolT* This, gtimerIdT id);
+static void wheel_Cascade(gtimerPoolT* This, unsigned slot);
+#endif
+
+/****************************************************************************/
+/*                                                                          */
+/*                  EXPORTED / IMPORTED GLOBAL VARIABLES                    */
+/*                                                                          */
+/****************************************************************************/
+
+volatile dword gtimerPendingTicks; // incremented when the interrupt triggered and further process is needed
+
+/****************************************************************************/
+/*                                                                          */
+/*                  NOT EXPORTED GLOBAL VARIABLES                           */
+/*                                                                          */
+/****************************************************************************/
+
+/* storage of gTimers */
+static _gtimerStorageUnitT TimerStorage[GTIMER_POOL_SPACE_REQUIREMENT(_N_GTIMERS) / sizeof(_gtimerStorageUnitT)];
+
+/* default pool, made of the above storage */
+static gtimerPoolT DefaultPool;
+
+/* number of ticks processed in batches by gtimerOnTick, beyond the first one of each batch */
+static dword CoalescedTicks;
+
+/****************************************************************************/
+/*                                                                          */
+/*                  EXPORTED FUNCTIONS                                      */
+/*                                                                          */
+/****************************************************************************/
+
+/****************************************************************************/
+void gtimerInitModule(void)
+/****************************************************************************/
+{
+#ifdef GTIMER_IMPLEMENTS_NS
+ gtimerPoolCtorNs(&DefaultPool, _N_GTIMERS, TimerStorage);
+#else
+ gtimerPoolCtor(&DefaultPool, _N_GTIMERS, TimerStorage);
+#endif
+ CoalescedTicks = 0;
+}
+
+/****************************************************************************/
+gtimerIdT gtimerRequest(void)
+/****************************************************************************/
+{
+ return gtimerPoolRequest(&DefaultPool);
+}
+
+/****************************************************************************/
+gtimerIdT gtimerReserve(gtimerIdT id)
+/****************************************************************************/
+{
+ return gtimerPoolReserve(&DefaultPool, id);
+}
+
+/****************************************************************************/
+gtimerIdT gtimerRelease(gtimerIdT id)
+/****************************************************************************/
+{
+ return gtimerPoolRelease(&DefaultPool, id);
+}
+
+/****************************************************************************/
+void gtimerInitAndStart(gtimerIdT id, dword count, boolean bAuto)
+/****************************************************************************/
+{
+ gtimerPoolInitAndStart(&DefaultPool, id, TICKS_TO_POOL(count), bAuto);
+}
+
+/****************************************************************************/
+void gtimerRestart(gtimerIdT id)
+/****************************************************************************/
+{
+ gtimerPoolRestart(&DefaultPool, id);
+}
+
+/****************************************************************************/
+void gtimerFreeze(gtimerIdT id)
+/****************************************************************************/
+{
+ gtimerPoolFreeze(&DefaultPool, id);
+}
+
+/****************************************************************************/
+void gtimerResume(gtimerIdT id)
+/****************************************************************************/
+{
+ gtimerPoolResume(&DefaultPool, id);
+}
+
+/****************************************************************************/
+void gtimerFastForward(gtimerIdT id)
+/****************************************************************************/
+{
+ gtimerPoolFastForward(&DefaultPool, id);
+}
+
+/****************************************************************************/
+boolean gtimerRunning(gtimerIdT id)
+/****************************************************************************/
+{
+ return gtimerPoolRunning(&DefaultPool, id);
+}
+
+/****************************************************************************/
+boolean gtimerTO(gtimerIdT id)
+/****************************************************************************/
+{
+ return gtimerPoolTO(&DefaultPool, id);
+}
+
+/****************************************************************************/
+dword gtimerGetTimeToGo(gtimerIdT id)
+/****************************************************************************/
+{
+ return POOL_TO_TICKS(gtimerPoolGetTimeToGo(&DefaultPool, id));
+}
+
+/****************************************************************************/
+dword gtimerTicksUntilNextExpiry(void)
+/****************************************************************************/
+{
+ return POOL_TO_TICKS(gtimerPoolTicksUntilNextExpiry(&DefaultPool));
+}
+
+/****************************************************************************/
+void gtimerAdvance(dword ticks)
+/****************************************************************************/
+{
+ gtimerPoolAdvance(&DefaultPool, TICKS_TO_POOL(ticks));
+}
+
+/****************************************************************************/
+void gtimerOnTick(void)
+/****************************************************************************/
+{
+ dword ticks;
+
+#ifdef __GNUC__
+ ticks = __atomic_exchange_n(&gtimerPendingTicks, 0, __ATOMIC_ACQUIRE);
+#else
+ GTIMER_ENTER_CRITICAL();
+ ticks = gtimerPendingTicks;
+ gtimerPendingTicks = 0;
+ GTIMER_EXIT_CRITICAL();
+#endif
+#ifdef GTIMER_IMPLEMENTS_NS
+ (void)ticks;                             // time is given by the clock
+ gtimerPoolPollNs(&DefaultPool);
+#else
+ if (ticks > 1)
+  {
+   CoalescedTicks += ticks - 1;
+   gtimerPoolAdvance(&DefaultPool, ticks);
+  }
+ else
+  {
+   gtimerPoolOnTick(&DefaultPool);
+  }
+#endif
+}
+
+/****************************************************************************/
+dword gtimerGetAndClearCoalescedTicks(boolean bClear)
+/****************************************************************************/
+{
+ dword ticks = CoalescedTicks;
+
+ if (bClear)
+  {
+   CoalescedTicks = 0;
+  }
+ return ticks;
+}
+
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+/****************************************************************************/
+void gtimerSetCallback(gtimerIdT id, gtimerCallbackPtr pCallback, dword inValue, dword* pOutValue)
+/****************************************************************************/
+{
+ gtimerPoolSetCallback(&DefaultPool, id, pCallback, inValue, pOutValue);
+}
+
+/****************************************************************************/
+void gtimerSetRearmCallback(gtimerIdT id, gtimerCallbackPtr pCallback, dword inValue)
+/****************************************************************************/
+{
+ gtimerPoolSetRearmCallback(&DefaultPool, id, pCallback, inValue);
+}
+
+/****************************************************************************/
+void gtimerSetCallbackInput(gtimerIdT id, dword inValue)
+/****************************************************************************/
+{
+ gtimerPoolSetCallbackInput(&DefaultPool, id, inValue);
+}
+
+/****************************************************************************/
+void gtimerClearCallback(gtimerIdT id)
+/****************************************************************************/
+{
+ gtimerPoolClearCallback(&DefaultPool, id);
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_SLACK
+/****************************************************************************/
+void gtimerSetSlack(gtimerIdT id, dword slack)
+/****************************************************************************/
+{
+ gtimerPoolSetSlack(&DefaultPool, id, TICKS_TO_POOL(slack));
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_NS
+/****************************************************************************/
+void gtimerInitAndStartNs(gtimerIdT id, dword ns, boolean bAuto)
+/****************************************************************************/
+{
+ gtimerPoolInitAndStart(&DefaultPool, id, ns, bAuto);
+}
+
+/****************************************************************************/
+void gtimerWaitNs(dword maxNs)
+/****************************************************************************/
+{
+ gtimerPoolWaitNs(&DefaultPool, maxNs);
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_STATS
+/****************************************************************************/
+void gtimerGetStats(gtimerIdT id, gtimerStatsT* pStats, boolean bClear)
+/****************************************************************************/
+{
+ gtimerPoolGetStats(&DefaultPool, id, pStats, bClear);
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+/****************************************************************************/
+dword gtimerDispatch(dword maxEvents)
+/****************************************************************************/
+{
+ return gtimerPoolDispatch(&DefaultPool, maxEvents);
+}
+
+/****************************************************************************/
+dword gtimerGetAndClearDispatchOverruns(boolean bClear)
+/****************************************************************************/
+{
+ return gtimerPoolGetAndClearDispatchOverruns(&DefaultPool, bClear);
+}
+#endif
+
+/****************************************************************************/
+boolean gtimerPoolCtor(gtimerPoolT* This, dword nbOfTimers, void* storage)
+/****************************************************************************/
+{
+ gtimerIdT id;
+ dword w;
+ byte* pStorage = (byte*)storage;
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ unsigned slot;
+#endif
+
+ if (storage == NULL || nbOfTimers == 0 || (gtimerIdT)nbOfTimers != nbOfTimers)
+  {
+   return FALSE;
+  }
+ This->nbOfTimers = (gtimerIdT)nbOfTimers;
+ This->tickCount = 0;
+ This->freeHint = 0;
+#ifdef GTIMER_IMPLEMENTS_NS
+ This->bNsClock = FALSE;
+ This->bProcessing = FALSE;
+#endif
+ /* same carving as GTIMER_POOL_SPACE_REQUIREMENT */
+ This->reqMap = (dword*)carve_Storage(&pStorage, GTIMER_BITMAP_WORDS(nbOfTimers) * sizeof(dword));
+ This->runningMap = (dword*)carve_Storage(&pStorage, GTIMER_BITMAP_WORDS(nbOfTimers) * sizeof(dword));
+ This->pendingMap = (dword*)carve_Storage(&pStorage, GTIMER_BITMAP_WORDS(nbOfTimers) * sizeof(dword));
+ This->timeoutMap = (dword*)carve_Storage(&pStorage, GTIMER_BITMAP_WORDS(nbOfTimers) * sizeof(dword));
+ This->autoMap = (dword*)carve_Storage(&pStorage, GTIMER_BITMAP_WORDS(nbOfTimers) * sizeof(dword));
+ This->expiry = (dword*)carve_Storage(&pStorage, nbOfTimers * sizeof(dword));
+ This->count = (dword*)carve_Storage(&pStorage, nbOfTimers * sizeof(dword));
+ This->count0 = (dword*)carve_Storage(&pStorage, nbOfTimers * sizeof(dword));
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+ This->rearmMap = (dword*)carve_Storage(&pStorage, GTIMER_BITMAP_WORDS(nbOfTimers) * sizeof(dword));
+ This->pCallback = (gtimerCallbackPtr*)carve_Storage(&pStorage, nbOfTimers * sizeof(gtimerCallbackPtr));
+ This->inValue = (dword*)carve_Storage(&pStorage, nbOfTimers * sizeof(dword));
+ This->pOutValue = (dword**)carve_Storage(&pStorage, nbOfTimers * sizeof(dword*));
+#endif
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+ This->armings = (dword*)carve_Storage(&pStorage, nbOfTimers * sizeof(dword));
+#endif
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ This->next = (gtimerIdT*)carve_Storage(&pStorage, nbOfTimers * sizeof(gtimerIdT));
+ This->prev = (gtimerIdT*)carve_Storage(&pStorage, nbOfTimers * sizeof(gtimerIdT));
+#endif
+#ifdef GTIMER_IMPLEMENTS_SLACK
+ This->nominal = (dword*)carve_Storage(&pStorage, nbOfTimers * sizeof(dword));
+ This->slack = (dword*)carve_Storage(&pStorage, nbOfTimers * sizeof(dword));
+#endif
+#ifdef GTIMER_IMPLEMENTS_STATS
+ This->stats = (gtimerStatsT*)carve_Storage(&pStorage, nbOfTimers * sizeof(gtimerStatsT));
+ This->batchEnd = 0;
+#endif
+ for (w = 0; w < GTIMER_BITMAP_WORDS(nbOfTimers); w++)   // storage may hold anything
+  {
+   This->reqMap[w] = 0;
+   This->runningMap[w] = 0;
+   This->pendingMap[w] = 0;
+   This->timeoutMap[w] = 0;
+   This->autoMap[w] = 0;
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+   This->rearmMap[w] = 0;
+#endif
+  }
+ if (nbOfTimers % DWORD_BITS != 0)
+  {
+   This->reqMap[nbOfTimers / DWORD_BITS] = ~(dword)0 << (nbOfTimers % DWORD_BITS);   // never requested
+  }
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+ This->dispatchIn = 0;
+ This->dispatchOut = 0;
+ This->dispatchOverruns = 0;
+#endif
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ for (slot = 0; slot <= GTIMER_WHEEL_OVERFLOW_SLOT; slot++)
+  {
+   This->wheelHead[slot] = This->nbOfTimers;
+  }
+ for (slot = 0; slot < GTIMER_WHEEL_MAP_WORDS; slot++)
+  {
+   This->wheelMap[slot] = 0;
+  }
+#endif
+ for (id = 0; id < This->nbOfTimers; id++)
+  {
+   init_Timer(This, id);
+#ifdef GTIMER_IMPLEMENTS_STATS
+   gtimerPoolGetStats(This, id, NULL, TRUE);
+#endif
+  }
+ return TRUE;
+}
+
+#ifdef GTIMER_IMPLEMENTS_NS
+/****************************************************************************/
+boolean gtimerPoolCtorNs(gtimerPoolT* This, dword nbOfTimers, void* storage)
+/****************************************************************************/
+{
+ if (gtimerPoolCtor(This, nbOfTimers, storage) == FALSE)
+  {
+   return FALSE;
+  }
+ This->tickCount = monotonic_Ns();          // empty wheel: tick count can start anywhere
+ This->bNsClock = TRUE;
+ return TRUE;
+}
+
+/****************************************************************************/
+void gtimerPoolPollNs(gtimerPoolT* This)
+/****************************************************************************/
+{
+ dword now = monotonic_Ns();
+
+ if ((long)(now - This->tickCount) > 0)
+  {
+   This->bProcessing = TRUE;                  // callbacks start delays from their own time-out
+   gtimerPoolAdvance(This, now - This->tickCount);
+   This->bProcessing = FALSE;
+  }
+}
+
+/****************************************************************************/
+void gtimerPoolWaitNs(gtimerPoolT* This, dword maxNs)
+/****************************************************************************/
+{
+ dword toGo = gtimerPoolTicksUntilNextExpiry(This);   // from now on
+ dword deadline;
+ struct timespec ts;
+
+ if (toGo == 0 || toGo > maxNs)
+  {
+   toGo = maxNs;
+  }
+ deadline = This->tickCount + toGo;
+ ts.tv_sec = (time_t)(deadline / 1000000000);
+ ts.tv_nsec = (long)(deadline % 1000000000);
+ while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+  {
+  }
+ gtimerPoolPollNs(This);
+}
+#endif
+
+/****************************************************************************/
+dword gtimerPoolSpaceRequirement(dword nbOfTimers)
+/****************************************************************************/
+{
+ return GTIMER_POOL_SPACE_REQUIREMENT(nbOfTimers);
+}
+
+/****************************************************************************/
+void gtimerPoolOnTick(gtimerPoolT* This)
+/****************************************************************************/
+{
+#ifdef GTIMER_IMPLEMENTS_STATS
+ This->batchEnd = This->tickCount + 1;
+#endif
+ process_Tick(This);
+}
+
+/****************************************************************************/
+gtimerIdT gtimerPoolRequest(gtimerPoolT* This)
+/****************************************************************************/
+{
+ gtimerIdT id;
+ dword w;
+
+ for (w = This->freeHint; w < GTIMER_BITMAP_WORDS(This->nbOfTimers); w++)
+  {
+   if (This->reqMap[w] != ~(dword)0)
+    {
+     id = (gtimerIdT)(w * DWORD_BITS + lowest_BitSet(~This->reqMap[w]));
+     BIT_SET(This->reqMap, id);
+     This->freeHint = w;
+     return id;
+    }
+  }
+ This->freeHint = w;
+
+ return This->nbOfTimers;
+}
+
+/****************************************************************************/
+gtimerIdT gtimerPoolReserve(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ if (id >= This->nbOfTimers)
+  {
+   return This->nbOfTimers;
+  }
+
+ if (BIT_TEST(This->reqMap, id))
+  {
+   return This->nbOfTimers;
+  }
+
+ BIT_SET(This->reqMap, id);
+
+ return id;
+}
+
+/****************************************************************************/
+gtimerIdT gtimerPoolRelease(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ if (id >= This->nbOfTimers)
+  {
+   return This->nbOfTimers;
+  }
+
+ init_Timer(This, id);
+
+ return id;
+}
+
+/****************************************************************************/
+void gtimerPoolInitAndStart(gtimerPoolT* This, gtimerIdT id, dword count, boolean bAuto)
+/****************************************************************************/
+{
+ if (BIT_TEST(This->reqMap, id) == 0)
+  {
+   return;
+  }
+ CATCH_UP(This);
+ if (count < 2)
+  {
+   count = 2;
+  }
+ This->count0[id] = count;                // set reload value
+ BIT_WRITE(This->autoMap, id, bAuto);     // auto restarts at timeout
+ BIT_CLEAR(This->timeoutMap, id);         // clears timeout condition
+ BIT_SET(This->runningMap, id);           // start timer
+ arm_Timer(This, id, count);              // set count value
+ TRACE(traceGtimerStart, id);
+}
+
+/****************************************************************************/
+void gtimerPoolRestart(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ gtimerPoolInitAndStart(This, id, This->count0[id], BIT_TEST(This->autoMap, id));
+}
+
+/****************************************************************************/
+void gtimerPoolFreeze(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ CATCH_UP(This);
+ disarm_Timer(This, id);                      // keeps ticks to go
+ BIT_CLEAR(This->runningMap, id);             // stop running
+}
+
+/****************************************************************************/
+void gtimerPoolResume(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ if (BIT_TEST(This->reqMap, id) || (BIT_TEST(This->autoMap, id) == 0 && BIT_TEST(This->timeoutMap, id)))
+  {
+   BIT_SET(This->runningMap, id);   // start timer with last count
+   CATCH_UP(This);
+   if (BIT_TEST(This->pendingMap, id) == 0 && This->count[id] > 0)
+    {
+     arm_Timer(This, id, This->count[id]);
+    }
+  }
+}
+
+/****************************************************************************/
+void gtimerPoolFastForward(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ if (BIT_TEST(This->reqMap, id) || BIT_TEST(This->runningMap, id))
+  {
+   if (BIT_TEST(This->runningMap, id))
+    {
+     CATCH_UP(This);
+     arm_Timer(This, id, 1);
+    }
+   else
+    {
+     This->count[id] = 1;
+    }
+  }
+}
+
+/****************************************************************************/
+boolean gtimerPoolRunning(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ return BIT_TEST(This->runningMap, id);
+}
+
+/****************************************************************************/
+boolean gtimerPoolTO(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ boolean bRet = BIT_TEST(This->timeoutMap, id);
+
+ if (BIT_TEST(This->autoMap, id))
+  {
+   BIT_CLEAR(This->timeoutMap, id);
+  }
+ return bRet;
+}
+
+/****************************************************************************/
+dword gtimerPoolGetTimeToGo(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ CATCH_UP(This);
+ if (BIT_TEST(This->pendingMap, id))
+  {
+   return This->expiry[id] - This->tickCount;
+  }
+ return This->count[id];
+}
+
+/****************************************************************************/
+dword gtimerPoolTicksUntilNextExpiry(gtimerPoolT* This)
+/****************************************************************************/
+{
+ CATCH_UP(This);
+ return next_Expiry(This);
+}
+
+/****************************************************************************/
+void gtimerPoolAdvance(gtimerPoolT* This, dword ticks)
+/****************************************************************************/
+{
+ dword toGo;
+
+#ifdef GTIMER_IMPLEMENTS_STATS
+ This->batchEnd = This->tickCount + ticks;   // time-outs before it are processed late
+#endif
+ while (ticks > 0)
+  {
+   toGo = next_Expiry(This);
+   if (toGo == 0 || toGo > ticks)
+    {
+     skip_Ticks(This, ticks);             // nothing times out till the end
+     return;
+    }
+   skip_Ticks(This, toGo - 1);
+   process_Tick(This);                    // deals with the next expiry
+   ticks -= toGo;
+  }
+}
+
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+/****************************************************************************/
+void gtimerPoolSetCallback(gtimerPoolT* This, gtimerIdT id, gtimerCallbackPtr pCallback, dword inValue, dword* pOutValue)
+/****************************************************************************/
+{
+ This->pCallback[id] = pCallback;
+ This->inValue[id] = inValue;
+ This->pOutValue[id] = pOutValue;
+ BIT_CLEAR(This->rearmMap, id);
+}
+
+/****************************************************************************/
+void gtimerPoolSetRearmCallback(gtimerPoolT* This, gtimerIdT id, gtimerCallbackPtr pCallback, dword inValue)
+/****************************************************************************/
+{
+ gtimerPoolSetCallback(This, id, pCallback, inValue, NULL);
+ BIT_SET(This->rearmMap, id);
+}
+
+/****************************************************************************/
+void gtimerPoolSetCallbackInput(gtimerPoolT* This, gtimerIdT id, dword inValue)
+/****************************************************************************/
+{
+ This->inValue[id] = inValue;
+}
+
+/****************************************************************************/
+void gtimerPoolClearCallback(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ This->pCallback[id] = NULL;
+ This->inValue[id] = 0;
+ This->pOutValue[id] = NULL;
+ BIT_CLEAR(This->rearmMap, id);
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+ drop_Events(This, id);                       // after the callback is gone: no new event can be queued
+#endif
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_SLACK
+/****************************************************************************/
+void gtimerPoolSetSlack(gtimerPoolT* This, gtimerIdT id, dword slack)
+/****************************************************************************/
+{
+ This->slack[id] = slack;
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_STATS
+/****************************************************************************/
+void gtimerPoolGetStats(gtimerPoolT* This, gtimerIdT id, gtimerStatsT* pStats, boolean bClear)
+/****************************************************************************/
+{
+ unsigned bucket;
+ gtimerStatsT* pTimerStats = This->stats + id;
+
+ for (bucket = 0; bucket < GTIMER_STATS_BUCKETS; bucket++)
+  {
+   if (pStats != NULL)
+    {
+     pStats->lateness[bucket] = pTimerStats->lateness[bucket];
+     pStats->callbackCycles[bucket] = pTimerStats->callbackCycles[bucket];
+    }
+   if (bClear)
+    {
+     pTimerStats->lateness[bucket] = 0;
+     pTimerStats->callbackCycles[bucket] = 0;
+    }
+  }
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+/****************************************************************************/
+dword gtimerPoolDispatch(gtimerPoolT* This, dword maxEvents)
+/****************************************************************************/
+{
+ gtimerEventT* pEvent;
+
+ for (; maxEvents > 0 && This->dispatchOut != This->dispatchIn; maxEvents--)
+  {
+   pEvent = This->dispatchRing + (This->dispatchOut++ & (GTIMER_DISPATCH_RING_SIZE - 1));
+   if (pEvent->id < This->nbOfTimers && BIT_TEST(This->reqMap, pEvent->id) && This->pCallback[pEvent->id] != NULL)
+    {
+     run_Callback(This, pEvent->id, pEvent->inValue, pEvent->armings == This->armings[pEvent->id]);
+    }
+  }
+ return This->dispatchIn - This->dispatchOut;
+}
+
+/****************************************************************************/
+dword gtimerPoolGetAndClearDispatchOverruns(gtimerPoolT* This, boolean bClear)
+/****************************************************************************/
+{
+ dword overruns = This->dispatchOverruns;
+
+ if (bClear)
+  {
+   This->dispatchOverruns = 0;
+  }
+ return overruns;
+}
+#endif
+
+/****************************************************************************/
+/*                                                                          */
+/*                  NOT EXPORTED FUNCTIONS                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/****************************************************************************/
+static void* carve_Storage(byte** ppStorage, dword size)
+/****************************************************************************/
+{
+ void* p = *ppStorage;
+
+ *ppStorage += _GTIMER_POOL_ARRAY_SIZE(size, 1);
+ return p;
+}
+
+/****************************************************************************/
+static void init_Timer(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ disarm_Timer(This, id);
+ BIT_CLEAR(This->reqMap, id);
+ if (id / DWORD_BITS < This->freeHint)
+  {
+   This->freeHint = id / DWORD_BITS;
+  }
+ This->count[id] = 0;
+ This->count0[id] = 0;
+ BIT_CLEAR(This->runningMap, id);
+ BIT_CLEAR(This->autoMap, id);
+#ifdef GTIMER_IMPLEMENTS_SLACK
+ This->slack[id] = 0;
+#endif
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+ gtimerPoolClearCallback(This, id);
+#endif
+
+}
+
+/****************************************************************************/
+static void arm_Timer(gtimerPoolT* This, gtimerIdT id, dword count)
+/****************************************************************************/
+{
+ disarm_Timer(This, id);
+ This->count[id] = count;
+ if (count > 0)
+  {
+#ifdef GTIMER_IMPLEMENTS_SLACK
+   This->nominal[id] = This->tickCount + count;
+   This->expiry[id] = slack_Expiry(This, id);
+#else
+   This->expiry[id] = This->tickCount + count;
+#endif
+   BIT_SET(This->pendingMap, id);
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+   wheel_Link(This, id);
+#endif
+  }
+}
+
+/****************************************************************************/
+static void disarm_Timer(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+ This->armings[id]++;                         // queued time-outs of the timer no longer rearm it
+#endif
+ if (BIT_TEST(This->pendingMap, id))
+  {
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+   wheel_Unlink(This, id);
+#endif
+   This->count[id] = This->expiry[id] - This->tickCount;   // ticks to go are kept
+   BIT_CLEAR(This->pendingMap, id);
+  }
+}
+
+/****************************************************************************/
+static void expire_Timer(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ TRACE(traceGtimerExpire, id);
+ BIT_SET(This->timeoutMap, id);
+#ifdef GTIMER_IMPLEMENTS_STATS
+ count_InHistogram(This->stats[id].lateness, This->batchEnd - This->tickCount);
+#endif
+ if (BIT_TEST(This->autoMap, id))
+  {
+#ifdef GTIMER_IMPLEMENTS_SLACK
+   This->nominal[id] += This->count0[id];     // periods stay anchored to nominal deadlines
+   This->expiry[id] = slack_Expiry(This, id);
+#else
+   This->expiry[id] = This->tickCount + This->count0[id];
+#endif
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+   wheel_Link(This, id);
+#endif
+  }
+ else
+  {
+   BIT_CLEAR(This->pendingMap, id);
+   This->count[id] = 0;
+   BIT_CLEAR(This->runningMap, id);
+  }
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+ if (This->pCallback[id] != NULL)
+  {
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+   if (This->dispatchIn - This->dispatchOut < GTIMER_DISPATCH_RING_SIZE)
+    {
+     gtimerEventT* pEvent = This->dispatchRing + (This->dispatchIn++ & (GTIMER_DISPATCH_RING_SIZE - 1));
+     pEvent->id = id;
+     pEvent->inValue = This->inValue[id];
+     pEvent->armings = This->armings[id];
+     return;
+    }
+   This->dispatchOverruns++;              // ring full: run now rather than lose it
+#endif
+   run_Callback(This, id, This->inValue[id], TRUE);
+  }
+#endif
+}
+
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+/****************************************************************************/
+static void run_Callback(gtimerPoolT* This, gtimerIdT id, dword inValue, boolean bRearm)
+/****************************************************************************/
+{
+ dword outValue;
+#ifdef GTIMER_IMPLEMENTS_STATS
+ dword cycles = GTIMER_GET_CYCLES();
+#endif
+
+ TRACE(traceGtimerCallbackEnter, id);
+ outValue = This->pCallback[id](id, inValue);
+ TRACE(traceGtimerCallbackExit, id);
+#ifdef GTIMER_IMPLEMENTS_STATS
+ count_InHistogram(This->stats[id].callbackCycles, GTIMER_GET_CYCLES() - cycles);
+#endif
+ if (BIT_TEST(This->rearmMap, id) == 0)
+  {
+   if (This->pOutValue[id] != NULL)
+    {
+     *This->pOutValue[id] = outValue;
+    }
+  }
+ else if (bRearm && BIT_TEST(This->reqMap, id))    // not if the timer changed since its time-out, or was released
+  {
+   if (outValue == GTIMER_CALLBACK_STOP)
+    {
+     disarm_Timer(This, id);
+     This->count[id] = 0;
+     BIT_CLEAR(This->runningMap, id);
+    }
+   else if (outValue != GTIMER_CALLBACK_KEEP)
+    {
+     This->count0[id] = outValue;
+     BIT_SET(This->runningMap, id);
+     arm_Timer(This, id, outValue);
+    }
+  }
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+/****************************************************************************/
+static void drop_Events(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ dword index;
+
+ for (index = This->dispatchOut; index != This->dispatchIn; index++)
+  {
+   gtimerEventT* pEvent = This->dispatchRing + (index & (GTIMER_DISPATCH_RING_SIZE - 1));
+   if (pEvent->id == id)
+    {
+     pEvent->id = This->nbOfTimers;           // no such timer: skipped by dispatch
+    }
+  }
+}
+#endif
+
+/****************************************************************************/
+static unsigned lowest_BitSet(dword value)
+/****************************************************************************/
+{
+#ifdef __GNUC__
+ return __builtin_ctzl(value);
+#else
+ unsigned bit;
+
+ for (bit = 0; (value & 1) == 0; bit++)
+  {
+   value >>= 1;
+  }
+ return bit;
+#endif
+}
+
+#ifdef GTIMER_IMPLEMENTS_NS
+/****************************************************************************/
+static dword monotonic_Ns(void)
+/****************************************************************************/
+{
+ struct timespec ts;
+
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return (dword)ts.tv_sec * 1000000000 + (dword)ts.tv_nsec;
+}
+
+/****************************************************************************/
+static void catch_Up(gtimerPoolT* This)
+/****************************************************************************/
+{
+ dword late;
+ dword toGo;
+
+ if (This->bNsClock == FALSE || This->bProcessing)
+  {
+   return;
+  }
+ late = monotonic_Ns() - This->tickCount;
+ if ((long)late > 0)
+  {
+   /* time-outs already due are left to gtimerPoolPollNs: tick count stops right before the first of them */
+   toGo = next_Expiry(This);
+   if (toGo != 0 && toGo <= late)
+    {
+     late = toGo - 1;
+    }
+   skip_Ticks(This, late);
+  }
+}
+#endif
+
+#if defined(GTIMER_IMPLEMENTS_STATS) || defined(GTIMER_IMPLEMENTS_SLACK)
+/****************************************************************************/
+static unsigned highest_BitSet(dword value)
+/****************************************************************************/
+{
+#ifdef __GNUC__
+ return DWORD_BITS - 1 - __builtin_clzl(value);
+#else
+ unsigned bit;
+
+ for (bit = 0; (value >>= 1) != 0; bit++)
+  {
+  }
+ return bit;
+#endif
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_SLACK
+/****************************************************************************/
+static dword slack_Expiry(const gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ dword from = This->nominal[id];
+ dword limit;
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ dword expiry;
+#endif
+
+ if ((long)(from - This->tickCount) <= 0)
+  {
+   from = This->tickCount + 1;              // slack larger than period: next tick at the earliest
+  }
+ limit = from + This->slack[id];
+ if (limit < from)
+  {
+   limit = ~(dword)0;                       // window does not wrap around
+  }
+ if (limit == from)
+  {
+   return from;
+  }
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ /* a timer already times out within the window on level 0: joins it */
+ if (((limit ^ This->tickCount) >> GTIMER_WHEEL_SLOT_BITS) == 0)
+  {
+   for (expiry = from; expiry != limit + 1; expiry++)
+    {
+     if (BIT_TEST(This->wheelMap, expiry & WHEEL_SLOT_MASK))
+      {
+       return expiry;
+      }
+    }
+  }
+#endif
+ /* roundest tick of the window (the most trailing zero bits), where other timers are likely to land too */
+ return limit & ~(((dword)1 << highest_BitSet(from ^ limit)) - 1);
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_STATS
+/****************************************************************************/
+static void count_InHistogram(dword* histogram, dword value)
+/****************************************************************************/
+{
+ unsigned bucket = value == 0 ? 0 : highest_BitSet(value) + 1;
+
+ if (bucket >= GTIMER_STATS_BUCKETS)
+  {
+   bucket = GTIMER_STATS_BUCKETS - 1;
+  }
+ histogram[bucket]++;
+}
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+/****************************************************************************/
+static unsigned wheel_SlotOf(const gtimerPoolT* This, dword expiry)
+/****************************************************************************/
+{
+ dword diff = (expiry ^ This->tickCount) >> GTIMER_WHEEL_SLOT_BITS;
+ unsigned level;
+
+ if (expiry < This->tickCount)
+  {
+   return GTIMER_WHEEL_OVERFLOW_SLOT;  // will be seen again when tick count wraps around
+  }
+ for (level = 0; diff != 0; level++)
+  {
+   diff >>= GTIMER_WHEEL_SLOT_BITS;
+  }
+ return level * GTIMER_WHEEL_SLOTS + ((expiry >> (level * GTIMER_WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK);
+}
+
+/****************************************************************************/
+static void wheel_Link(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ unsigned slot = wheel_SlotOf(This, This->expiry[id]);
+
+ This->prev[id] = This->nbOfTimers;
+ This->next[id] = This->wheelHead[slot];
+ if (This->next[id] != This->nbOfTimers)
+  {
+   This->prev[This->next[id]] = id;
+  }
+ else if (slot != GTIMER_WHEEL_OVERFLOW_SLOT)
+  {
+   BIT_SET(This->wheelMap, slot);
+  }
+ This->wheelHead[slot] = id;
+}
+
+/****************************************************************************/
+static void wheel_Unlink(gtimerPoolT* This, gtimerIdT id)
+/****************************************************************************/
+{
+ unsigned slot;
+
+ if (This->prev[id] == This->nbOfTimers)
+  {
+   slot = wheel_SlotOf(This, This->expiry[id]);
+   This->wheelHead[slot] = This->next[id];
+   if (This->next[id] == This->nbOfTimers && slot != GTIMER_WHEEL_OVERFLOW_SLOT)
+    {
+     BIT_CLEAR(This->wheelMap, slot);
+    }
+  }
+ else
+  {
+   This->next[This->prev[id]] = This->next[id];
+  }
+ if (This->next[id] != This->nbOfTimers)
+  {
+   This->prev[This->next[id]] = This->prev[id];
+  }
+}
+
+/****************************************************************************/
+static void wheel_Cascade(gtimerPoolT* This, unsigned slot)
+/****************************************************************************/
+{
+ gtimerIdT id = This->wheelHead[slot];
+
+ This->wheelHead[slot] = This->nbOfTimers;
+ if (slot != GTIMER_WHEEL_OVERFLOW_SLOT)
+  {
+   BIT_CLEAR(This->wheelMap, slot);
+  }
+ while (id != This->nbOfTimers)
+  {
+   gtimerIdT next = This->next[id];
+   wheel_Link(This, id);                 // lands on a lower level
+   id = next;
+  }
+}
+#endif
+
+/****************************************************************************/
+static dword next_Expiry(gtimerPoolT* This)
+/****************************************************************************/
+{
+ dword toGo = 0;
+ gtimerIdT id;
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ unsigned i;
+ unsigned slot = GTIMER_WHEEL_OVERFLOW_SLOT;
+
+ for (i = 0; i < GTIMER_WHEEL_MAP_WORDS; i++)
+  {
+   if (This->wheelMap[i] != 0)
+    {
+     slot = i * DWORD_BITS + lowest_BitSet(This->wheelMap[i]);
+     break;
+    }
+  }
+ id = This->wheelHead[slot];
+ if (slot < GTIMER_WHEEL_SLOTS)
+  {
+   return This->expiry[id] - This->tickCount;   // all timers of a level-0 slot share the same expiry
+  }
+ for (; id != This->nbOfTimers; id = This->next[id])
+  {
+   if (toGo == 0 || This->expiry[id] - This->tickCount < toGo)
+    {
+     toGo = This->expiry[id] - This->tickCount;
+    }
+  }
+#else
+ dword w;
+ dword bits;
+
+ for (w = 0; w < GTIMER_BITMAP_WORDS(This->nbOfTimers); w++)
+  {
+   for (bits = This->pendingMap[w]; bits != 0; bits &= bits - 1)
+    {
+     id = (gtimerIdT)(w * DWORD_BITS + lowest_BitSet(bits));
+     if (toGo == 0 || This->expiry[id] - This->tickCount < toGo)
+      {
+       toGo = This->expiry[id] - This->tickCount;
+      }
+    }
+  }
+#endif
+ return toGo;
+}
+
+/****************************************************************************/
+static void skip_Ticks(gtimerPoolT* This, dword ticks)
+/****************************************************************************/
+{
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ unsigned level;
+ dword from;
+
+ if (ticks == 0)
+  {
+   return;
+  }
+ if (This->tickCount + ticks < This->tickCount)
+  {
+   /* goes through tick count wrap around the normal way */
+   ticks -= ~This->tickCount + 1;
+   skip_Ticks(This, ~This->tickCount);
+   process_Tick(This);
+  }
+ /* no timer expires in between: so for each level, slots between the former and the new tick count
+    are empty, and only the slot of the new tick count may hold timers which now belong to lower levels */
+ from = This->tickCount;
+ This->tickCount += ticks;
+ for (level = GTIMER_WHEEL_LEVELS - 1; level > 0; level--)
+  {
+   if ((This->tickCount >> (level * GTIMER_WHEEL_SLOT_BITS)) != (from >> (level * GTIMER_WHEEL_SLOT_BITS)))
+    {
+     wheel_Cascade(This, level * GTIMER_WHEEL_SLOTS + ((This->tickCount >> (level * GTIMER_WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK));
+    }
+  }
+#else
+ This->tickCount += ticks;
+#endif
+}
+
+/****************************************************************************/
+static void process_Tick(gtimerPoolT* This)
+/****************************************************************************/
+{
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ unsigned level;
+ dword ticks;
+ gtimerIdT id;
+
+ This->tickCount++;
+ if ((This->tickCount & WHEEL_SLOT_MASK) == 0)
+  {
+   /* some upper level digits of tick count changed: their current slots have to be dispatched on lower levels */
+   if (This->tickCount == 0)
+    {
+     wheel_Cascade(This, GTIMER_WHEEL_OVERFLOW_SLOT);
+    }
+   for (level = 1, ticks = This->tickCount >> GTIMER_WHEEL_SLOT_BITS;
+        level < GTIMER_WHEEL_LEVELS - 1 && (ticks & WHEEL_SLOT_MASK) == 0;
+        level++, ticks >>= GTIMER_WHEEL_SLOT_BITS)
+    {
+    }
+   for (; level > 0; level--)
+    {
+     wheel_Cascade(This, level * GTIMER_WHEEL_SLOTS + ((This->tickCount >> (level * GTIMER_WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK));
+    }
+  }
+ /* current level-0 slot only holds timers timing out right now */
+ while ((id = This->wheelHead[This->tickCount & WHEEL_SLOT_MASK]) != This->nbOfTimers)
+  {
+   wheel_Unlink(This, id);
+   expire_Timer(This, id);
+  }
+#else
+ gtimerIdT id;
+ dword w;
+ dword bits;
+
+ This->tickCount++;
+ for (w = 0; w < GTIMER_BITMAP_WORDS(This->nbOfTimers); w++)
+  {
+   /* a callback may stop timers of this word: they are checked again */
+   for (bits = This->pendingMap[w]; bits != 0; bits &= bits - 1)
+    {
+     id = (gtimerIdT)(w * DWORD_BITS + lowest_BitSet(bits));
+     if (This->expiry[id] == This->tickCount && BIT_TEST(This->pendingMap, id))
+      {
+       expire_Timer(This, id);
+      }
+    }
+  }
+#endif
+}
@@ -1,255 +1,755 @@
-#ifndef __GTIMER_DEFINED__
-#define __GTIMER_DEFINED__
-
-/**
- * \defgroup gTimer generic software timer
- * \{
- * This module is implements soft timers: function \c gtimerOnTick should be called when a hard timer tick has elapsed.
- * It is based on 32-bit counts and in order for conversion functions to work properly, it assumes associated timer tick to be one
- * millisecond or more.\n
- * Functions in this module allows to use a certain number of independent timers:\n
- * - defined by their zero based id's
- * - quantity defined by \c _N_GTIMERS (timer id's are always less than this value)
- *
- * For each of them, timer count can be started or stop, a timeout condition can be tested against a duration.
- * Timer can stop or automatically restart after this given duration.
- * It's also possible to associate a call-back function (of type \c gtimerCallbackPtr)which is called when this duration has elapsed\n
- * None of those functions are thread safe and interrupt safe: so #gtimerOnTick as it is should not be called within
- * an interrupt but in main loop. However #gtimerOnTick will reset a flag #bTimerInterruptFired which
- * should be set by the interrupt. So #gtimerOnTick should be called when #bTimerInterruptFired is true\n
- * This module will work as long as \c _N_GTIMERS is defined. Also, \c GTIMER_TICK_MS should be defined: it instructs the
- * module how many milliseconds a tick represents. Considering the minimum value for this tick and the count word width, a minimum
- * delay of 49 days can be measured
- * \note management of callbacks take some more RAM in internal arrays. To avoid using memory for not needed functionalities,
- * \c GTIMER_IMPLEMENTS_CALLBACK should be defined in order to have this callback mechanism implemented
- * \warning - for efficiency purpose, zero-based id of timers given as parameters of most of the functions
- * of this module are not controlled to be less than _N_GTIMERS. This is not safe and imposes external control or double check they cannot
- * be higher than expected
- * - in order to ensure a certain accuracy the minimum delay for #gtimerInitAndStart is 2 ticks
- *
- * \file gtimer.h
- * \brief header of the gTimer module
- * \author Gerard Gauthier
- * \date 2015/01
- */
-
-/****************************************************************************/
-/*                                                                          */
-/*                  MODULE DEPENDENCY                                       */
-/*                                                                          */
-/****************************************************************************/
-
-#include "terms.h" /* where boolean, dword, word, byte... should be defined as types */
-#include "system.h" /* where GTIMER_TICK_MS and _N_GTIMERS should be defined (also GTIMER_IMPLEMENTS_CALLBACK) */
-
-/****************************************************************************/
-/*                                                                          */
-/*                  DEFINITIONS AND MACROS                                  */
-/*                                                                          */
-/****************************************************************************/
-
-/* basic macros to transform ticks to time and time to ticks */
-/** Timer tick to milliseconds, conversion macro */
-#define GTIMER_TICK_TO_MS(ticks) ((dword)GTIMER_TICK_MS * (ticks))
-/** Timer tick to seconds, conversion macro */
-#define GTIMER_TICK_TO_S(ticks)  (((dword)GTIMER_TICK_MS * (ticks) + 500) / 1000)
-/** Timer tick to minutes, conversion macro */
-#define GTIMER_TICK_TO_MN(ticks) ((dword)GTIMER_TICK_MS * (ticks) + 60 * 500) / 60 / 1000)
-/** Timer tick to hours, conversion macro */
-#define GTIMER_TICK_TO_HRS(ticks) ((dword)GTIMER_TICK_MS * (ticks) + 60 * 60 * 500)) / 60 / 60 / 1000)
-
-/** milliseconds to timer ticks, conversion macro */
-#define GTIMER_MS_TO_TICKS(ms) ((dword)(ms) / GTIMER_TICK_MS)
-/** seconds to timer ticks, conversion macro */
-#define GTIMER_S_TO_TICKS(s) ((dword)(s) * 1000 / GTIMER_TICK_MS)
-/** minutes to timer ticks, conversion macro */
-#define GTIMER_MN_TO_TICKS(m) ((dword)(m) * 60 * 1000 / GTIMER_TICK_MS)
-/** hours to timer ticks, conversion macro */
-#define GTIMER_HR_TO_TICKS(h) ((dword)(h) * 60 * 60 / GTIMER_TICK_MS)
-
-/***************************/
-/* Compiler Error Handler  */
-/***************************/
-#ifndef _N_GTIMERS
-  #error _N_GTIMERS is not defined
-#endif
-#ifndef GTIMER_TICK_MS /* number of milliseconds a timer tick represents */
-  #error GTIMER_TICK_MS is not defined
-#endif
-
-/****************************************************************************/
-/*                                                                          */
-/*                  TYPE DEFINITIONS                                        */
-/*                                                                          */
-/****************************************************************************/
-
-#ifdef GTIMER_IMPLEMENTS_CALLBACK
-/** \brief **callback mechanism: function automatically called on timeout**
-
- This function takes a user parameter in addition to the timer id and returns
- a value which may be used by user provided a non NULL pointer to return value
- is defined
- \see \c gtimerSetCallback
-*/
-typedef dword (*gtimerCallbackPtr)(byte id, dword value);
-#endif
-
-/****************************************************************************/
-/*                                                                          */
-/*                  EXPORTED GLOBAL VARIABLES                               */
-/*                                                                          */
-/****************************************************************************/
-/**
-  This flag should be set to true by a hard timer implementation, normally through an interrupt\n
-  It should be tested as true before calling #gtimerOnTick
- */
-volatile boolean bTimerInterruptFired; // true when the interrupt triggered and further process is needed
-
-/****************************************************************************/
-/*                                                                          */
-/*                  PROTOTYPES OF EXPORTED FUNCTIONS                        */
-/*                                                                          */
-/****************************************************************************/
-
-/** \brief **timer pulse**
- *
- * This routine should be called upon each tick, actually every time flag #bTimerInterruptFired
- * turns true
- * \note #bTimerInterruptFired is set to \c FALSE by this function
- */
-void gtimerOnTick(void);
-
-/** \brief **module initializer**
- *
- * Initializes all resources in this module
- * \warning This function must be called
- * prior to any other function of this module being called
- */
-void gtimerInitModule(void);
-
-/**\brief **request a timer out of the pool of available timers**
- *
- * This function requests one of the available resources. If a resource
- * is available, the resource id will be returned. If there are no more
- * resources available, \c _N_GTIMERS will be returned to indicate the error
- * situation. Other errors also return \c _N_GTIMERS
- * \return zero-based id of the timer, or \c _N_GTIMERS in case of error
- */
-byte gtimerRequest(void);
-
-/** \brief **reserves a timer with a given timer id**
- *
- * This function tries to reserve a specific resource id. If the resource
- * is available, the same resource id will be returned. If it was already
- * in use, \c _N_GTIMERS will be returned to indicate the error situation.
- * Other errors also return \c _N_GTIMERS
- * \return given parameter if ok, or \c _N_GTIMERS in case of error
- */
-byte gtimerReserve(byte id /**< zero-based timer id */);
-
-/** \brief **release timer id**
- *
- * This function releases the specified resource id. The resource is
- * set back to the initial state. Errors return \c _N_GTIMERS
- * \return given parameter if ok, or \c _N_GTIMERS in case of error
- */
-byte gtimerRelease(byte id /**< zero-based timer id */);
-
-/** \brief **starts a given timer to run**
- *
- * The timer stops after \p ticks *times* \c GTIMER_TICK_MS
- * Use the \ref gtimerTO timeout function to check whether or not the timer has elapsed.
- * If \c bAuto is \c TRUE, timer constantly runs, reloading its value as long it
- * has reached its timeout
- * \warning minimum value for \p ticks is 2!
- */
-void gtimerInitAndStart(byte id /**< zero-based timer id */,
-                        dword ticks /**< number of timer ticks before time-out */,
-                        boolean bAuto /**< auto-reload flag */);
-
-/** \brief **restarts the cycle initiated by #gtimerInitAndStart**
- *
- * It can be called any time during a cycle (before or after timeout condition has occurred)
- */
-void gtimerRestart(byte id /**< zero-based timer id */);
-
-/** \brief **stops timer counting**
- *
- * This function stops the given timer, leaving the current count value
- * intact The timer can be resumed for the remaining time by calling
- * #gtimerRestart
- */
-void gtimerFreeze(byte id /**< zero-based timer id */);
-
-/** \brief **resumes counting**
- *
- * This function restarts the timer after #gtimerFreeze for the time remaining
- */
-void gtimerResume(byte id /**< zero-based timer id */);
-
-/** \brief **rushes to time-out condition**
- *
- * This function ensures a timeout condition will occur within one timer tick
- */
-void gtimerFastForward(byte id /**< zero-based timer id */);
-
-/** \brief **is timer running?**
- *
- * \return \c TRUE if timer is running
- * \note When *not* in auto-mode and timer has reached its timeout, timer is
- *       considered *no longer* running and then this will return FALSE
- */
-boolean gtimerRunning(byte id /**< zero-based timer id */);
-
-/** \brief **has timer reached a time-out condition?**
- *
- * Informs whether timer count cycle has elapsed
- * \return \c TRUE if the time which was passed by the #gtimerInitAndStart function has
- * elapsed, and \c FALSE otherwise
- * \note when in auto mode and timeout has elapsed, this function will only
- * returned \c TRUE one time (per cycle): next calls to it within the next period
- * will return \c FALSE
- */
-boolean gtimerTO(byte id /**< zero-based timer id */);
-
-/** \brief **remaining time before time-out**
- *
- * \return the number of timer ticks to go before timeout will become \c TRUE
- * \note in auto mode, returns the number of ticks to finish the current cycle
- */
-dword gtimerGetTimeToGo(byte id /**< zero-based timer id */);
-
-#ifdef GTIMER_IMPLEMENTS_CALLBACK
-
-/** \brief **attach call-back function**
- *
- * Set:
- * - timeout call-back function,
- * - its \p inValue, and
- * - a pointer to its \c out returned value.
- *   This pointer can be \c NULL and in this case the returned value is not passed
- */
-void gtimerSetCallback(byte id /**< zero-based timer id */,
-                       gtimerCallbackPtr pCallback /**< call back function */,
-                       dword inValue /**< initial input value for the call-back function */,
-                       dword* pOutValue /**< reference to out variable call-back can update */);
-
-/** \brief **set new call-back input value**
- */
-void gtimerSetCallbackInput(byte id /**< zero-based timer id */,
-                            dword inValue /**< updated input value for the call-back function */);
-
-/** \brief **detach call-back function**
- */
-void gtimerClearCallback(byte id /**< zero-based timer id */);
-
-/*
- * Disable any call-back previously defined
- */
-#endif /* GTIMER_IMPLEMENTS_CALLBACK */
-
-/**
- * \}
- */
-
-#endif /* __GTIMER_DEFINED__ */
+#ifndef __GTIMER_DEFINED__
+#define __GTIMER_DEFINED__
+
+/**
+ * \defgroup gTimer generic software timer
+ * \{
+ * This module is implements soft timers: function \c gtimerOnTick should be called when a hard timer tick has elapsed.
+ * It is based on 32-bit counts and in order for conversion functions to work properly, it assumes associated timer tick to be one
+ * millisecond or more.\n
+ * Functions in this module allows to use a certain number of independent timers:\n
+ * - defined by their zero based id's
+ * - quantity defined by \c _N_GTIMERS (timer id's are always less than this value)
+ *
+ * Those timers make the default pool of timers. More independent pools (\ref gtimerPoolT), with their own time base
+ * and number of timers chosen at run time, can be constructed on storage provided by the caller (see #gtimerPoolCtor):
+ * functions of the \c gtimerPool family then act on a given pool exactly as their counterparts act on the default pool.
+ * As a pool only works on its own data, different pools can be run by different threads
+ *
+ * For each of them, timer count can be started or stop, a timeout condition can be tested against a duration.
+ * Timer can stop or automatically restart after this given duration.
+ * It's also possible to associate a call-back function (of type \c gtimerCallbackPtr)which is called when this duration has elapsed\n
+ * None of those functions are thread safe and interrupt safe: so #gtimerOnTick as it is should not be called within
+ * an interrupt but in main loop. However the interrupt should count ticks in #gtimerPendingTicks with #GTIMER_SIGNAL_TICK
+ * and #gtimerOnTick, called when #gtimerPendingTicks is not zero, will process all of them in one pass, so that no tick
+ * is lost when the main loop is late (how many ticks were so coalesced is given by #gtimerGetAndClearCoalescedTicks)\n
+ * This module will work as long as \c _N_GTIMERS is defined. Also, \c GTIMER_TICK_MS should be defined: it instructs the
+ * module how many milliseconds a tick represents. Considering the minimum value for this tick and the count word width, a minimum
+ * delay of 49 days can be measured
+ * \note management of callbacks take some more RAM in internal arrays. To avoid using memory for not needed functionalities,
+ * \c GTIMER_IMPLEMENTS_CALLBACK should be defined in order to have this callback mechanism implemented
+ * \note by default #gtimerOnTick scans all the \c _N_GTIMERS timers on each tick. When many timers are used,
+ * \c GTIMER_IMPLEMENTS_WHEEL should be defined: running timers are then hooked by their expiry tick in a hierarchical
+ * timing wheel (\c GTIMER_WHEEL_SLOT_BITS bits per level, 6 by default) so that the work done on a tick only depends on the
+ * number of timers actually timing out on that tick (plus an amortized cascading of far timers). It costs some more RAM: two
+ * timer id's per timer and one timer id per wheel slot
+ * \note tickless operation: instead of waking up on every tick, the host can ask #gtimerTicksUntilNextExpiry how long it
+ * may sleep, program its hard timer accordingly, and on wake up apply all the elapsed ticks at once with #gtimerAdvance.
+ * With \c GTIMER_IMPLEMENTS_WHEEL the next expiry is found from an occupancy bitmap of the wheel slots
+ * instead of a scan of all timers
+ * \note callbacks normally run from #gtimerOnTick, so that a slow one delays the next time-outs of the same tick.
+ * With \c GTIMER_IMPLEMENTS_DEFERRED_CALLBACK also defined, a time-out only queues its timer id and callback input value
+ * in a ring of \c GTIMER_DISPATCH_RING_SIZE events, and callbacks are run later, as many as the application chooses,
+ * by #gtimerDispatch
+ * \note an auto-reloaded timer times out every \c count0 ticks after its first deadline: as time-outs are processed on
+ * their very tick, periods do not drift. With \c GTIMER_IMPLEMENTS_SLACK defined, a timer can also be given a slack
+ * (#gtimerSetSlack): each of its time-outs may then occur up to that many ticks after its nominal deadline, on a tick
+ * where other timers time out, so that there are fewer distinct wake-up ticks. Next periods still count from nominal
+ * deadlines, so that slack never accumulates
+ * \note high resolution mode, on Linux: with \c GTIMER_IMPLEMENTS_NS defined, the tick count of the default pool is
+ * the \c CLOCK_MONOTONIC time in nanoseconds, so that timers hold absolute deadlines on this clock.
+ * #gtimerInitAndStartNs starts a timer with a delay in nanoseconds while the other functions keep working in ticks
+ * of \c GTIMER_TICK_MS, converted on the fly (time to go is rounded up to the next tick). No periodic tick is
+ * needed: #gtimerOnTick processes what timed out up to now, whenever it is called, and #gtimerWaitNs sleeps
+ * until the next deadline and processes it. Delays start from the time they are set, except in callbacks run
+ * while time-outs are processed, where they start from the deadline being processed (so that timers do not drift). Pools of the same kind
+ * are built with #gtimerPoolCtorNs
+ * \note with \c GTIMER_IMPLEMENTS_STATS defined, each timer records in log2 histograms how late its time-outs are processed
+ * (in ticks, for example when the main loop lets pending ticks pile up) and how long its callback runs (in cycles of
+ * \c GTIMER_GET_CYCLES): see #gtimerGetStats. Nothing of it is compiled otherwise
+ * \note with \c GTIMER_IMPLEMENTS_TRACE defined, starts, time-outs and callbacks of timers are recorded in the ring of the
+ * \ref trace module (\c trace.c should then be built too), timer id's being truncated to 16 bits
+ * \warning - for efficiency purpose, zero-based id of timers given as parameters of most of the functions
+ * of this module are not controlled to be less than _N_GTIMERS. This is not safe and imposes external control or double check they cannot
+ * be higher than expected
+ * - in order to ensure a certain accuracy the minimum delay for #gtimerInitAndStart is 2 ticks
+ *
+ * \file gtimer.h
+ * \brief header of the gTimer module
+ * \author Gerard Gauthier
+ * \date 2015/01
+ */
+
+/****************************************************************************/
+/*                                                                          */
+/*                  MODULE DEPENDENCY                                       */
+/*                                                                          */
+/****************************************************************************/
+
+#include "terms.h" /* where boolean, dword, word, byte... should be defined as types */
+#include "system.h" /* where GTIMER_TICK_MS and _N_GTIMERS should be defined (also GTIMER_IMPLEMENTS_CALLBACK) */
+
+/****************************************************************************/
+/*                                                                          */
+/*                  DEFINITIONS AND MACROS                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/* basic macros to transform ticks to time and time to ticks */
+/** Timer tick to milliseconds, conversion macro */
+#define GTIMER_TICK_TO_MS(ticks) ((dword)GTIMER_TICK_MS * (ticks))
+/** Timer tick to seconds, conversion macro */
+#define GTIMER_TICK_TO_S(ticks)  (((dword)GTIMER_TICK_MS * (ticks) + 500) / 1000)
+/** Timer tick to minutes, conversion macro */
+#define GTIMER_TICK_TO_MN(ticks) ((dword)GTIMER_TICK_MS * (ticks) + 60 * 500) / 60 / 1000)
+/** Timer tick to hours, conversion macro */
+#define GTIMER_TICK_TO_HRS(ticks) ((dword)GTIMER_TICK_MS * (ticks) + 60 * 60 * 500)) / 60 / 60 / 1000)
+
+/** milliseconds to timer ticks, conversion macro */
+#define GTIMER_MS_TO_TICKS(ms) ((dword)(ms) / GTIMER_TICK_MS)
+/** seconds to timer ticks, conversion macro */
+#define GTIMER_S_TO_TICKS(s) ((dword)(s) * 1000 / GTIMER_TICK_MS)
+/** minutes to timer ticks, conversion macro */
+#define GTIMER_MN_TO_TICKS(m) ((dword)(m) * 60 * 1000 / GTIMER_TICK_MS)
+/** hours to timer ticks, conversion macro */
+#define GTIMER_HR_TO_TICKS(h) ((dword)(h) * 60 * 60 / GTIMER_TICK_MS)
+
+/***************************/
+/* Compiler Error Handler  */
+/***************************/
+#ifndef _N_GTIMERS
+  #error _N_GTIMERS is not defined
+#endif
+#ifndef GTIMER_TICK_MS /* number of milliseconds a timer tick represents */
+  #error GTIMER_TICK_MS is not defined
+#endif
+
+/****************************************************************************/
+/*                                                                          */
+/*                  TYPE DEFINITIONS                                        */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef GTIMER_MAX_POOL_SIZE /* largest number of timers of a pool (see gtimerPoolCtor) */
+ #define GTIMER_MAX_POOL_SIZE _N_GTIMERS
+#endif
+
+/** \brief zero-based timer id
+ *
+ * As narrow as \c _N_GTIMERS and \c GTIMER_MAX_POOL_SIZE allow (the size of a pool itself being returned as an error)
+ */
+#if _N_GTIMERS < 0x100 && GTIMER_MAX_POOL_SIZE < 0x100
+typedef byte gtimerIdT;
+#elif _N_GTIMERS < 0x10000 && GTIMER_MAX_POOL_SIZE < 0x10000
+typedef word gtimerIdT;
+#else
+typedef dword gtimerIdT;
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+/** \brief **callback mechanism: function automatically called on timeout**
+
+ This function takes a user parameter in addition to the timer id and returns
+ a value which may be used by user provided a non NULL pointer to return value
+ is defined\n
+ Installed with #gtimerSetRearmCallback, its return value rather tells what becomes of the timer:
+ #GTIMER_CALLBACK_STOP, #GTIMER_CALLBACK_KEEP or a number of ticks before the next time-out
+ \see \c gtimerSetCallback
+*/
+typedef dword (*gtimerCallbackPtr)(gtimerIdT id, dword value);
+
+/** returned by a callback installed with #gtimerSetRearmCallback: stops the timer */
+#define GTIMER_CALLBACK_STOP ((dword)0)
+/** returned by a callback installed with #gtimerSetRearmCallback: timer goes on as without callback */
+#define GTIMER_CALLBACK_KEEP (~(dword)0)
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+ #ifndef GTIMER_IMPLEMENTS_CALLBACK
+  #error GTIMER_IMPLEMENTS_DEFERRED_CALLBACK needs GTIMER_IMPLEMENTS_CALLBACK
+ #endif
+ #ifndef GTIMER_DISPATCH_RING_SIZE /* time-outs which can wait for #gtimerDispatch, a power of two */
+  #define GTIMER_DISPATCH_RING_SIZE (16)
+ #endif
+ #if (GTIMER_DISPATCH_RING_SIZE & (GTIMER_DISPATCH_RING_SIZE - 1)) != 0
+  #error GTIMER_DISPATCH_RING_SIZE should be a power of two
+ #endif
+
+/** \brief time-out whose callback waits for #gtimerDispatch */
+typedef struct _gtimerEventT
+{
+ gtimerIdT id;                         // timer which timed out
+ dword inValue;                        // 'in' parameter of its callback at that time
+ dword armings;                        // armings of the timer at that time: its callback rearms it only if unchanged
+} gtimerEventT;
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_NS
+ #ifndef __linux__
+  #error GTIMER_IMPLEMENTS_NS relies on CLOCK_MONOTONIC and clock_nanosleep of Linux
+ #endif
+ #define GTIMER_NS_PER_TICK ((dword)GTIMER_TICK_MS * 1000000) /**< nanoseconds of one tick of the API */
+/* nanosecond tick counts need a 64-bit dword (LP64 targets) */
+typedef char _gtimerNsNeeds64BitDword[sizeof(dword) >= 8 ? 1 : -1];
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_STATS
+ #ifndef GTIMER_STATS_BUCKETS /* buckets of the histograms of #gtimerStatsT */
+  #define GTIMER_STATS_BUCKETS (16)
+ #endif
+ #ifndef GTIMER_GET_CYCLES /* free running cycle counter, possibly defined in system.h */
+  #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+   #define GTIMER_GET_CYCLES() ((dword)__builtin_ia32_rdtsc())
+  #elif defined(__GNUC__) && defined(__aarch64__)
+   #define GTIMER_GET_CYCLES() __extension__({ unsigned long long _c; __asm__ volatile("mrs %0, cntvct_el0" : "=r"(_c)); (dword)_c; })
+  #else
+   #error GTIMER_GET_CYCLES should be defined for this target to read a cycle counter
+  #endif
+ #endif
+
+/** \brief **histograms of one timer**
+ *
+ * Bucket 0 counts zero values, bucket \c k counts values from 2^(k-1) to 2^k - 1 and the last bucket
+ * also counts all the values beyond
+ */
+typedef struct _gtimerStatsT
+{
+ dword lateness[GTIMER_STATS_BUCKETS];  /**< ticks between time-out and its processing by the pool */
+ dword callbackCycles[GTIMER_STATS_BUCKETS]; /**< duration of the callback, in \c GTIMER_GET_CYCLES units */
+} gtimerStatsT;
+#endif
+
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ #ifndef GTIMER_WHEEL_SLOT_BITS
+  #define GTIMER_WHEEL_SLOT_BITS (6)
+ #endif
+ #define GTIMER_WHEEL_SLOTS (1 << GTIMER_WHEEL_SLOT_BITS) /**< number of slots of one level of the timing wheel */
+ #define GTIMER_WHEEL_LEVELS ((8 * sizeof(dword) + GTIMER_WHEEL_SLOT_BITS - 1) / GTIMER_WHEEL_SLOT_BITS) /**< levels of the wheel */
+ #define GTIMER_WHEEL_OVERFLOW_SLOT (GTIMER_WHEEL_LEVELS * GTIMER_WHEEL_SLOTS) /**< extra slot after all levels */
+ #define GTIMER_WHEEL_MAP_WORDS ((GTIMER_WHEEL_OVERFLOW_SLOT + 8 * sizeof(dword) - 1) / (8 * sizeof(dword))) /**< size of slot bitmap */
+#endif
+
+/** number of words of a bitmap with one bit per timer */
+#define GTIMER_BITMAP_WORDS(NB_OF_TIMERS) (((NB_OF_TIMERS) + 8 * sizeof(dword) - 1) / (8 * sizeof(dword)))
+
+/** \brief unit in which the storage of a pool is carved, so that each of its arrays stays aligned */
+typedef union _gtimerStorageUnitT
+{
+ dword d;
+ void* p;
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+ gtimerCallbackPtr f;
+#endif
+} _gtimerStorageUnitT;
+
+/** size of a pool array of \p N items of \p SIZE bytes, rounded up to storage units */
+#define _GTIMER_POOL_ARRAY_SIZE(N, SIZE) \
+ (((N) * (SIZE) + sizeof(_gtimerStorageUnitT) - 1) / sizeof(_gtimerStorageUnitT) * sizeof(_gtimerStorageUnitT))
+
+/** \brief pool of timers
+ *
+ * Members are only given to let the user allocate pools: they should be accessed through the \c gtimerPool functions
+ * \note the state of timers is split in parallel arrays (one per field), and flags are held in bitmaps, so that
+ * scans only touch the words they need: finding a free timer reads the in-use bitmap and looking for time-outs
+ * only visits timers whose bit is set in the pending bitmap
+ * \note when pools are run by different threads, they had better not share cache lines
+ */
+typedef struct _gtimerPoolT
+{
+ gtimerIdT nbOfTimers;                 // number of timers
+ dword tickCount;                      // number of ticks elapsed since construction
+ dword freeHint;                       // all the words of reqMap before this one are full
+ dword* reqMap;                        // bitmap of timers in use (bits beyond nbOfTimers are set)
+ dword* runningMap;                    // bitmap of started timers
+ dword* pendingMap;                    // bitmap of running timers with ticks to go: expiry is meaningful
+ dword* timeoutMap;                    // bitmap of timers which reached a timeout
+ dword* autoMap;                       // bitmap of auto-reload timers
+ dword* expiry;                        // value of tick count at which each timer times out (when pending)
+ dword* count;                         // periods of GTIMER_TICK_MS to run before time out (when not pending)
+ dword* count0;                        // reload values
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+ dword* rearmMap;                      // bitmap of timers whose callback return value rearms them
+ gtimerCallbackPtr* pCallback;         // functions to call when timers expire
+ dword* inValue;                       // their 'in' parameter
+ dword** pOutValue;                    // references to their 'out' parameter
+#endif
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ gtimerIdT* next;                      // next timer in the same wheel slot (pool size if none)
+ gtimerIdT* prev;                      // previous timer in the same wheel slot (pool size if none)
+ gtimerIdT wheelHead[GTIMER_WHEEL_OVERFLOW_SLOT + 1]; // first timer of each wheel slot, plus overflow slot
+ dword wheelMap[GTIMER_WHEEL_MAP_WORDS]; // one bit per non empty wheel slot (overflow slot excepted)
+#endif
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+ dword* armings;                       // times each timer was armed, rearmed, frozen or stopped
+ gtimerEventT dispatchRing[GTIMER_DISPATCH_RING_SIZE]; // time-outs waiting for their callback
+ dword dispatchIn;                     // number of events ever queued
+ dword dispatchOut;                    // number of events ever dispatched
+ dword dispatchOverruns;               // callbacks run on time-out as the ring was full
+#endif
+#ifdef GTIMER_IMPLEMENTS_SLACK
+ dword* nominal;                       // deadlines before slack applies (when pending)
+ dword* slack;                         // ticks by which each timer may time out late
+#endif
+#ifdef GTIMER_IMPLEMENTS_NS
+ boolean bNsClock;                     // tick count is CLOCK_MONOTONIC in nanoseconds
+ boolean bProcessing;                  // time-outs being processed: tick count is their time
+#endif
+#ifdef GTIMER_IMPLEMENTS_STATS
+ gtimerStatsT* stats;                  // histograms of each timer
+ dword batchEnd;                       // tick count once the ticks being processed are all processed
+#endif
+} gtimerPoolT;
+
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+ #define _GTIMER_POOL_CALLBACK_SPACE(N) (_GTIMER_POOL_ARRAY_SIZE(GTIMER_BITMAP_WORDS(N), sizeof(dword)) + \
+                                         _GTIMER_POOL_ARRAY_SIZE(N, sizeof(gtimerCallbackPtr)) + \
+                                         _GTIMER_POOL_ARRAY_SIZE(N, sizeof(dword)) + \
+                                         _GTIMER_POOL_ARRAY_SIZE(N, sizeof(dword*)))
+#else
+ #define _GTIMER_POOL_CALLBACK_SPACE(N) 0
+#endif
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+ #define _GTIMER_POOL_DEFERRED_SPACE(N) _GTIMER_POOL_ARRAY_SIZE(N, sizeof(dword))
+#else
+ #define _GTIMER_POOL_DEFERRED_SPACE(N) 0
+#endif
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+ #define _GTIMER_POOL_WHEEL_SPACE(N) (2 * _GTIMER_POOL_ARRAY_SIZE(N, sizeof(gtimerIdT)))
+#else
+ #define _GTIMER_POOL_WHEEL_SPACE(N) 0
+#endif
+#ifdef GTIMER_IMPLEMENTS_SLACK
+ #define _GTIMER_POOL_SLACK_SPACE(N) (2 * _GTIMER_POOL_ARRAY_SIZE(N, sizeof(dword)))
+#else
+ #define _GTIMER_POOL_SLACK_SPACE(N) 0
+#endif
+#ifdef GTIMER_IMPLEMENTS_STATS
+ #define _GTIMER_POOL_STATS_SPACE(N) _GTIMER_POOL_ARRAY_SIZE(N, sizeof(gtimerStatsT))
+#else
+ #define _GTIMER_POOL_STATS_SPACE(N) 0
+#endif
+
+/** Storage size to provide to #gtimerPoolCtor for a given number of timers */
+#define GTIMER_POOL_SPACE_REQUIREMENT(NB_OF_TIMERS) \
+ (5 * _GTIMER_POOL_ARRAY_SIZE(GTIMER_BITMAP_WORDS(NB_OF_TIMERS), sizeof(dword)) + \
+  3 * _GTIMER_POOL_ARRAY_SIZE(NB_OF_TIMERS, sizeof(dword)) + \
+  _GTIMER_POOL_CALLBACK_SPACE(NB_OF_TIMERS) + _GTIMER_POOL_DEFERRED_SPACE(NB_OF_TIMERS) + \
+  _GTIMER_POOL_WHEEL_SPACE(NB_OF_TIMERS) + \
+  _GTIMER_POOL_SLACK_SPACE(NB_OF_TIMERS) + _GTIMER_POOL_STATS_SPACE(NB_OF_TIMERS))
+
+/****************************************************************************/
+/*                                                                          */
+/*                  EXPORTED GLOBAL VARIABLES                               */
+/*                                                                          */
+/****************************************************************************/
+/**
+  Number of ticks not processed yet: it should be incremented by a hard timer implementation, normally
+  through an interrupt, with #GTIMER_SIGNAL_TICK\n
+  It should be tested as not zero before calling #gtimerOnTick
+ */
+extern volatile dword gtimerPendingTicks; // incremented when the interrupt triggered and further process is needed
+
+/** \def GTIMER_SIGNAL_TICK
+ *  \brief counts one more tick in #gtimerPendingTicks, to be used by the hard timer interrupt
+ *
+ * Atomic with \c GCC. Otherwise a simple increment is used, which is fine from an interrupt as long as the
+ * main loop cannot preempt it: \c GTIMER_ENTER_CRITICAL and \c GTIMER_EXIT_CRITICAL should then be defined
+ * (in \c system.h) to mask the tick interrupt while #gtimerOnTick fetches and resets the count
+ */
+#ifdef __GNUC__
+ #define GTIMER_SIGNAL_TICK() ((void)__atomic_add_fetch(&gtimerPendingTicks, 1, __ATOMIC_RELEASE))
+#else
+ #define GTIMER_SIGNAL_TICK() ((void)gtimerPendingTicks++)
+#endif
+
+/****************************************************************************/
+/*                                                                          */
+/*                  PROTOTYPES OF EXPORTED FUNCTIONS                        */
+/*                                                                          */
+/****************************************************************************/
+
+/** \brief **timer pulse**
+ *
+ * This routine should be called upon each tick, actually every time #gtimerPendingTicks
+ * is not zero. All the pending ticks are then processed in one batch (as #gtimerAdvance does)
+ * \note #gtimerPendingTicks is reset by this function, a call while it is zero accounts for one tick
+ */
+void gtimerOnTick(void);
+
+/** \brief **ticks which had to be processed in a batch**
+ *
+ * Each time #gtimerOnTick finds more than one pending tick, the extra ticks are counted as coalesced: they
+ * tell how late the main loop was
+ * \return number of coalesced ticks before this count is possibly cleared
+ */
+dword gtimerGetAndClearCoalescedTicks(boolean bClear /**< \c TRUE, should the count be cleared */);
+
+/** \brief **module initializer**
+ *
+ * Initializes all resources in this module
+ * \warning This function must be called
+ * prior to any other function of this module being called
+ */
+void gtimerInitModule(void);
+
+/**\brief **request a timer out of the pool of available timers**
+ *
+ * This function requests one of the available resources. If a resource
+ * is available, the resource id will be returned. If there are no more
+ * resources available, \c _N_GTIMERS will be returned to indicate the error
+ * situation. Other errors also return \c _N_GTIMERS
+ * \return zero-based id of the timer, or \c _N_GTIMERS in case of error
+ */
+gtimerIdT gtimerRequest(void);
+
+/** \brief **reserves a timer with a given timer id**
+ *
+ * This function tries to reserve a specific resource id. If the resource
+ * is available, the same resource id will be returned. If it was already
+ * in use, \c _N_GTIMERS will be returned to indicate the error situation.
+ * Other errors also return \c _N_GTIMERS
+ * \return given parameter if ok, or \c _N_GTIMERS in case of error
+ */
+gtimerIdT gtimerReserve(gtimerIdT id /**< zero-based timer id */);
+
+/** \brief **release timer id**
+ *
+ * This function releases the specified resource id. The resource is
+ * set back to the initial state. Errors return \c _N_GTIMERS
+ * \return given parameter if ok, or \c _N_GTIMERS in case of error
+ */
+gtimerIdT gtimerRelease(gtimerIdT id /**< zero-based timer id */);
+
+/** \brief **starts a given timer to run**
+ *
+ * The timer stops after \p ticks *times* \c GTIMER_TICK_MS
+ * Use the \ref gtimerTO timeout function to check whether or not the timer has elapsed.
+ * If \c bAuto is \c TRUE, timer constantly runs, reloading its value as long it
+ * has reached its timeout
+ * \warning minimum value for \p ticks is 2!
+ */
+void gtimerInitAndStart(gtimerIdT id /**< zero-based timer id */,
+                        dword ticks /**< number of timer ticks before time-out */,
+                        boolean bAuto /**< auto-reload flag */);
+
+/** \brief **restarts the cycle initiated by #gtimerInitAndStart**
+ *
+ * It can be called any time during a cycle (before or after timeout condition has occurred)
+ */
+void gtimerRestart(gtimerIdT id /**< zero-based timer id */);
+
+/** \brief **stops timer counting**
+ *
+ * This function stops the given timer, leaving the current count value
+ * intact The timer can be resumed for the remaining time by calling
+ * #gtimerRestart
+ */
+void gtimerFreeze(gtimerIdT id /**< zero-based timer id */);
+
+/** \brief **resumes counting**
+ *
+ * This function restarts the timer after #gtimerFreeze for the time remaining
+ */
+void gtimerResume(gtimerIdT id /**< zero-based timer id */);
+
+/** \brief **rushes to time-out condition**
+ *
+ * This function ensures a timeout condition will occur within one timer tick
+ */
+void gtimerFastForward(gtimerIdT id /**< zero-based timer id */);
+
+/** \brief **is timer running?**
+ *
+ * \return \c TRUE if timer is running
+ * \note When *not* in auto-mode and timer has reached its timeout, timer is
+ *       considered *no longer* running and then this will return FALSE
+ */
+boolean gtimerRunning(gtimerIdT id /**< zero-based timer id */);
+
+/** \brief **has timer reached a time-out condition?**
+ *
+ * Informs whether timer count cycle has elapsed
+ * \return \c TRUE if the time which was passed by the #gtimerInitAndStart function has
+ * elapsed, and \c FALSE otherwise
+ * \note when in auto mode and timeout has elapsed, this function will only
+ * returned \c TRUE one time (per cycle): next calls to it within the next period
+ * will return \c FALSE
+ */
+boolean gtimerTO(gtimerIdT id /**< zero-based timer id */);
+
+/** \brief **remaining time before time-out**
+ *
+ * \return the number of timer ticks to go before timeout will become \c TRUE
+ * \note in auto mode, returns the number of ticks to finish the current cycle
+ */
+dword gtimerGetTimeToGo(gtimerIdT id /**< zero-based timer id */);
+
+/** \brief **ticks to go before the next time-out of any timer**
+ *
+ * Tells how many ticks can elapse before one of the running timers reaches a time-out condition,
+ * for example to let the host sleep until then
+ * \return this number of ticks (1 or more), or zero if no timer is due to time out
+ */
+dword gtimerTicksUntilNextExpiry(void);
+
+/** \brief **applies several elapsed ticks in one call**
+ *
+ * Same effect as calling #gtimerOnTick \p ticks times: time-outs and callbacks occur in deadline order,
+ * auto-reloaded timers reloading at their expiry tick, but stretches of ticks where nothing expires are
+ * skipped at once
+ * \note unlike #gtimerOnTick, #gtimerPendingTicks is left untouched
+ */
+void gtimerAdvance(dword ticks /**< number of elapsed ticks */);
+
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+
+/** \brief **attach call-back function**
+ *
+ * Set:
+ * - timeout call-back function,
+ * - its \p inValue, and
+ * - a pointer to its \c out returned value.
+ *   This pointer can be \c NULL and in this case the returned value is not passed
+ */
+void gtimerSetCallback(gtimerIdT id /**< zero-based timer id */,
+                       gtimerCallbackPtr pCallback /**< call back function */,
+                       dword inValue /**< initial input value for the call-back function */,
+                       dword* pOutValue /**< reference to out variable call-back can update */);
+
+/** \brief **attach call-back function driving its timer**
+ *
+ * Same as #gtimerSetCallback, but the value returned by \p pCallback is applied to the timer when the call-back returns:
+ * - #GTIMER_CALLBACK_STOP: timer stops, as if it timed out not in auto mode
+ * - #GTIMER_CALLBACK_KEEP: timer is left as is (auto-reloaded or stopped, unless the call-back changed it)
+ * - any other value: timer times out again after this number of ticks, as a new reload value
+ *
+ * This saves a call to #gtimerRestart or #gtimerInitAndStart within the call-back
+ * \note a rearmed timer keeps its auto-reload flag and its time-out condition
+ * \note with \c GTIMER_IMPLEMENTS_DEFERRED_CALLBACK, the new delay counts from the tick the callback is dispatched on,
+ * not from the time-out, so it gets longer by the time the event waited in the ring
+ * \note a timer released by its callback is not rearmed
+ */
+void gtimerSetRearmCallback(gtimerIdT id /**< zero-based timer id */,
+                            gtimerCallbackPtr pCallback /**< call back function */,
+                            dword inValue /**< initial input value for the call-back function */);
+
+/** \brief **set new call-back input value**
+ */
+void gtimerSetCallbackInput(gtimerIdT id /**< zero-based timer id */,
+                            dword inValue /**< updated input value for the call-back function */);
+
+/** \brief **detach call-back function**
+ */
+void gtimerClearCallback(gtimerIdT id /**< zero-based timer id */);
+
+/*
+ * Disable any call-back previously defined
+ */
+#endif /* GTIMER_IMPLEMENTS_CALLBACK */
+
+#ifdef GTIMER_IMPLEMENTS_SLACK
+
+/** \brief **lets time-outs of a timer be delayed to share wake-ups**
+ *
+ * From the next time the timer is started or reloaded, its time-out can occur from its nominal deadline to \p slack
+ * ticks after. The tick chosen is the one of the window where a timer already times out if it is close enough
+ * (with \c GTIMER_IMPLEMENTS_WHEEL), otherwise the roundest one (the one with the most trailing zero bits), where
+ * other timers with slack tend to be gathered. Releasing the timer clears its slack
+ * \note \p slack should be less than the period of the timer
+ */
+void gtimerSetSlack(gtimerIdT id /**< zero-based timer id */, dword slack /**< largest delay of time-outs, in ticks */);
+
+#endif /* GTIMER_IMPLEMENTS_SLACK */
+
+#ifdef GTIMER_IMPLEMENTS_NS
+
+/** \brief **starts a given timer with a delay in nanoseconds**
+ *
+ * Same as #gtimerInitAndStart, with a delay in nanoseconds, the time-out occurring when #gtimerOnTick or
+ * #gtimerWaitNs is called at or after the deadline
+ */
+void gtimerInitAndStartNs(gtimerIdT id /**< zero-based timer id */,
+                          dword ns /**< number of nanoseconds before time-out */,
+                          boolean bAuto /**< auto-reload flag */);
+
+/** \brief **waits for the next deadline**
+ *
+ * Sleeps until the next deadline of a running timer, or for \p maxNs nanoseconds at most, then processes
+ * all the time-outs reached (as #gtimerOnTick does)
+ */
+void gtimerWaitNs(dword maxNs /**< longest sleep, in nanoseconds */);
+
+#endif /* GTIMER_IMPLEMENTS_NS */
+
+#ifdef GTIMER_IMPLEMENTS_STATS
+
+/** \brief **snapshot of the histograms of a timer**
+ *
+ * Copies the histograms of timer \p id into \p pStats, then possibly clears them
+ */
+void gtimerGetStats(gtimerIdT id /**< zero-based timer id */,
+                    gtimerStatsT* pStats /**< where to copy histograms */,
+                    boolean bClear /**< \c TRUE, should histograms be cleared */);
+
+#endif /* GTIMER_IMPLEMENTS_STATS */
+
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+
+/** \brief **runs queued callbacks**
+ *
+ * Runs the callbacks of at most \p maxEvents time-outs, oldest first, with the input value they had when their
+ * timer timed out. It should be called from the same context as #gtimerOnTick, for example after it in main loop
+ * \note the callback run is the one attached to the timer at dispatch time: none if it has been cleared meanwhile.
+ * Time-outs of a timer released meanwhile are dropped, so that they do not reach a new owner of its id. The callback
+ * of a timer started, frozen or stopped meanwhile is run, but the value it returns does not rearm the timer
+ * \return number of events still queued
+ */
+dword gtimerDispatch(dword maxEvents /**< largest number of callbacks to run */);
+
+/** \brief **callbacks which could not be deferred**
+ *
+ * When the ring is full, a callback is run on time-out, from #gtimerOnTick, rather than lost:
+ * this counts how many times it happened, which tells \c GTIMER_DISPATCH_RING_SIZE is too small or
+ * #gtimerDispatch is not called often enough
+ * \return this count before it is possibly cleared
+ */
+dword gtimerGetAndClearDispatchOverruns(boolean bClear /**< \c TRUE, should the count be cleared */);
+
+#endif /* GTIMER_IMPLEMENTS_DEFERRED_CALLBACK */
+
+/************************************************************
+ * pools of timers
+ ************************************************************/
+
+/** \brief **pool constructor**
+ *
+ * Makes \p This a pool of \p nbOfTimers timers, all released, with a tick count at zero
+ * \return \c FALSE if \p storage is \c NULL or \p nbOfTimers is zero or does not fit in \ref gtimerIdT
+ * (see \c GTIMER_MAX_POOL_SIZE)
+ */
+boolean gtimerPoolCtor(gtimerPoolT* This /**< pool to construct */,
+                       dword nbOfTimers /**< number of timers of the pool */,
+                       void* storage /**< #GTIMER_POOL_SPACE_REQUIREMENT(\p nbOfTimers) bytes, kept by the pool,
+                                        aligned for a \c dword and a pointer (as \c malloc does) */);
+
+/** \brief **storage size of a pool**
+ *
+ * Function counterpart of #GTIMER_POOL_SPACE_REQUIREMENT, useful for dynamic allocation
+ */
+dword gtimerPoolSpaceRequirement(dword nbOfTimers /**< number of timers of the pool */);
+
+#ifdef GTIMER_IMPLEMENTS_NS
+
+/** \brief **pool constructor, clocked in nanoseconds**
+ *
+ * Same as #gtimerPoolCtor, but the tick count of the pool is the \c CLOCK_MONOTONIC time in nanoseconds:
+ * all delays of the \c gtimerPool functions are then given in nanoseconds
+ */
+boolean gtimerPoolCtorNs(gtimerPoolT* This /**< pool to construct */,
+                         dword nbOfTimers /**< number of timers of the pool */,
+                         void* storage /**< #GTIMER_POOL_SPACE_REQUIREMENT(\p nbOfTimers) bytes, kept by the pool */);
+
+/** \brief **processes the time-outs of a nanosecond pool up to now** (see #gtimerOnTick) */
+void gtimerPoolPollNs(gtimerPoolT* This /**< pool built by #gtimerPoolCtorNs */);
+
+/** \brief see #gtimerWaitNs */
+void gtimerPoolWaitNs(gtimerPoolT* This /**< pool built by #gtimerPoolCtorNs */,
+                      dword maxNs /**< longest sleep, in nanoseconds */);
+
+#endif /* GTIMER_IMPLEMENTS_NS */
+
+/** \brief **one tick for a pool** (see #gtimerOnTick, pending ticks being left untouched) */
+void gtimerPoolOnTick(gtimerPoolT* This /**< pool */);
+
+/** \brief see #gtimerRequest (pool size returned in case of error) */
+gtimerIdT gtimerPoolRequest(gtimerPoolT* This /**< pool */);
+
+/** \brief see #gtimerReserve (pool size returned in case of error) */
+gtimerIdT gtimerPoolReserve(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+/** \brief see #gtimerRelease (pool size returned in case of error) */
+gtimerIdT gtimerPoolRelease(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+/** \brief see #gtimerInitAndStart */
+void gtimerPoolInitAndStart(gtimerPoolT* This /**< pool */,
+                            gtimerIdT id /**< zero-based timer id */,
+                            dword ticks /**< number of timer ticks before time-out */,
+                            boolean bAuto /**< auto-reload flag */);
+
+/** \brief see #gtimerRestart */
+void gtimerPoolRestart(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+/** \brief see #gtimerFreeze */
+void gtimerPoolFreeze(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+/** \brief see #gtimerResume */
+void gtimerPoolResume(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+/** \brief see #gtimerFastForward */
+void gtimerPoolFastForward(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+/** \brief see #gtimerRunning */
+boolean gtimerPoolRunning(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+/** \brief see #gtimerTO */
+boolean gtimerPoolTO(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+/** \brief see #gtimerGetTimeToGo */
+dword gtimerPoolGetTimeToGo(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+/** \brief see #gtimerTicksUntilNextExpiry */
+dword gtimerPoolTicksUntilNextExpiry(gtimerPoolT* This /**< pool */);
+
+/** \brief see #gtimerAdvance */
+void gtimerPoolAdvance(gtimerPoolT* This /**< pool */, dword ticks /**< number of elapsed ticks */);
+
+#ifdef GTIMER_IMPLEMENTS_CALLBACK
+
+/** \brief see #gtimerSetCallback */
+void gtimerPoolSetCallback(gtimerPoolT* This /**< pool */,
+                           gtimerIdT id /**< zero-based timer id */,
+                           gtimerCallbackPtr pCallback /**< call back function */,
+                           dword inValue /**< initial input value for the call-back function */,
+                           dword* pOutValue /**< reference to out variable call-back can update */);
+
+/** \brief see #gtimerSetRearmCallback */
+void gtimerPoolSetRearmCallback(gtimerPoolT* This /**< pool */,
+                                gtimerIdT id /**< zero-based timer id */,
+                                gtimerCallbackPtr pCallback /**< call back function */,
+                                dword inValue /**< initial input value for the call-back function */);
+
+/** \brief see #gtimerSetCallbackInput */
+void gtimerPoolSetCallbackInput(gtimerPoolT* This /**< pool */,
+                                gtimerIdT id /**< zero-based timer id */,
+                                dword inValue /**< updated input value for the call-back function */);
+
+/** \brief see #gtimerClearCallback */
+void gtimerPoolClearCallback(gtimerPoolT* This /**< pool */, gtimerIdT id /**< zero-based timer id */);
+
+#endif /* GTIMER_IMPLEMENTS_CALLBACK */
+
+#ifdef GTIMER_IMPLEMENTS_SLACK
+
+/** \brief see #gtimerSetSlack */
+void gtimerPoolSetSlack(gtimerPoolT* This /**< pool */,
+                        gtimerIdT id /**< zero-based timer id */,
+                        dword slack /**< largest delay of time-outs, in ticks of the pool */);
+
+#endif /* GTIMER_IMPLEMENTS_SLACK */
+
+#ifdef GTIMER_IMPLEMENTS_STATS
+
+/** \brief see #gtimerGetStats */
+void gtimerPoolGetStats(gtimerPoolT* This /**< pool */,
+                        gtimerIdT id /**< zero-based timer id */,
+                        gtimerStatsT* pStats /**< where to copy histograms */,
+                        boolean bClear /**< \c TRUE, should histograms be cleared */);
+
+#endif /* GTIMER_IMPLEMENTS_STATS */
+
+#ifdef GTIMER_IMPLEMENTS_DEFERRED_CALLBACK
+
+/** \brief see #gtimerDispatch */
+dword gtimerPoolDispatch(gtimerPoolT* This /**< pool */, dword maxEvents /**< largest number of callbacks to run */);
+
+/** \brief see #gtimerGetAndClearDispatchOverruns */
+dword gtimerPoolGetAndClearDispatchOverruns(gtimerPoolT* This /**< pool */,
+                                            boolean bClear /**< \c TRUE, should the count be cleared */);
+
+#endif /* GTIMER_IMPLEMENTS_DEFERRED_CALLBACK */
+
+/**
+ * \}
+ */
+
+#endif /* __GTIMER_DEFINED__ */
@@ -1,546 +1,1827 @@
-#include "swUart.h"
-
-#include "gtimer.h"
-
-#define QTY_OF_SENDERS (1)
-#define QTY_OF_RECEIVERS (1)
-
-#define MIN_BITS_SERIALIZED (3)
-#define MAX_BITS_SERIALIZED (10)
-
-/* for space constraints environments can be set to byte.
-   in this case characters more than 8-bit wide will be trimmed to a byte */
-#define RCPT_FIFO_TYPE          word /* byte or word */
-/* size of reception FIFO as defined in number of bits:
- * - 0 for size 1 (2 to the power of 0),
- * - 1 for size 2,
- * - 2 for size 4, ...
- * - up to 8 for size 256 (maximum value)
- */
-#define RCPT_FIFO_SIZE_IN_BITS (4) /* so size is 2^RCPT_FIFO_SIZE_IN_BITS */
-#define RCPT_FIFO_SIZE (1 << RCPT_FIFO_SIZE_IN_BITS) /* in case we need the associated size */
-#define RCPT_FIFO_SIZE_MASK (RCPT_FIFO_SIZE - 1) /* divide mask using the '&' operator */
-
-/* machine states for transmission */
-typedef enum { swUTIdle, swUTEdge, swUTStart, swUTBit, swUTParity, swUTStop1, swUTStop2 } swUartTxStateE;
-/* machine states for reception */
-typedef enum { swURIdle, swURStart, swURSBit, swURParity, swURStop1, swURStop2 } swUartRxStateE;
-
-/*
- * common part of state machine context
- */
-typedef struct
-{
- word serialChar;    /* char/word being serialized */
- byte timerId;    /* id of gTimer taking care of delays */
- byte bitPos : 4;  /* what bit is presently processed */
- byte nbOfBitsSet : 4;  /* for parity calculation */
-} swUartCommonPartOfStateMachineT;
-
-/*
- * state machine for transmission
- */
-typedef struct
-{
- swUartTxStateE state;    /* machine state */
- swUartHwSetTxFct txFct;    /* i/o function for setting Tx line state (mark or space) */
- swUartCommonPartOfStateMachineT c;    /* common part between Tx and Rx state machines */
- byte bInProgress : 1;  /* activity going on */
-} swUartTxStateMachineT;
-
-/*
- * state machine for reception
- */
-typedef struct
-{
- swUartRxStateE state;    /* machine state */
- byte error;    /* reception error */
- swUartHwGetRxFct rxFct;    /* i/o function for reading Rx line state (mark or space) */
- swUartCommonPartOfStateMachineT c;    /* common part between Tx and Rx state machines */
- RCPT_FIFO_TYPE rxFifo[1 << RCPT_FIFO_SIZE_IN_BITS];  /* FIFO queue to store incoming characters */
- byte rxFifoReadIndex;    /* location where an available character can be read */
- byte rxFifoWriteIndex;    /* location where an available character can be written  */
- byte bInProgress : 1;  /* activity going on */
- byte rxFifoEmpty : 1;  /* FIFO queue is empty - read and write index equals and queue is not full */
- byte dontStore : 1;  /* We got an error: don't store serialized value */
- byte scanPosition : 2;  /* sub state when scanning Rx state multiple times */
- byte scanValues : 2;  /* where to store scanned values */
-} swUartRxStateMachineT;
-
-/*
- * transmission data structure
- */
-typedef struct _swUartTxStruct
-{
- const swUartConfigurationT* pCfg;    /* configuration */
- swUartTxStateMachineT sm;    /* state machine */
-} swUartTxStruct;
-
-/*
- * reception data structure
- */
-typedef struct _swUartRxStruct
-{
- const swUartConfigurationT* pCfg;    /* configuration */
- swUartRxStateMachineT sm;    /* state machine */
-} swUartRxStruct;
-
-/* arrays of transmitter and receiver data structures */
-static swUartTxStruct _sendSArray[QTY_OF_SENDERS];
-static swUartRxStruct _receiveSArray[QTY_OF_RECEIVERS];
-
-/************************************************************
- * transmission section
- ************************************************************/
-
-static dword swUartSendCallBack(UNUSED_FCT_P byte id, dword value)
-{
- swUartTxStruct* pSendStruct = (swUartTxStruct*)value;
- swUartTxStateMachineT* pSM = &pSendStruct->sm;
- const swUartConfigurationT* pCfg = pSendStruct->pCfg;
- /* in this state machine, when we reach a state it means this state is done (pCfg->bitWidth
-    has elapsed) and we should act on next
-    this means we position the line state when new state is assigned */
- switch (pSM->state)
-  {
-   default:
-   case swUTIdle:  /* should never happen, as send routine which start timer set state to swUTStart */
-    return 0;
-   case swUTEdge:
-    pSM->txFct(swUSpace_Low);
-    pSM->state = swUTStart;
-    goto reloadTimerAndReturn;
-   case swUTStart:
-    pSM->state = swUTBit;   /* simply next stage, initializing bit counters */
-    pSM->c.bitPos = pSM->c.nbOfBitsSet = 0;
-    goto processBit;     /* can proceed to next stage now */
-   case swUTParity:
-    goto processStop1;     /* directly position line for first data bit (b0) */
-   case swUTBit:
-    if (pSM->c.bitPos >= pCfg->nbBits)  /* test whether we reached all the necessary bits for a character? */
-     {
-      switch (pCfg->parity)      /* necessary to position a parity? */
-       {
-        case swUNoParity:     /* no: let's start stop bit */
-        processStop1:
-         pSM->state = swUTStop1;
-         pSM->txFct(swUMark_High);
-         goto reloadTimerAndReturn;
-        case swUEvenParity:
-         /* even parity: parity bit set to high if number of high bits in data is odd */
-         pSM->txFct(pSM->c.nbOfBitsSet & 1 ? swUMark_High : swUSpace_Low);
-         goto endOfParityProcessing;
-        case swUOddParity:
-         pSM->txFct(pSM->c.nbOfBitsSet & 1 ? swUSpace_Low : swUMark_High);
-        endOfParityProcessing:
-         pSM->state = swUTParity;      /* to notify parity is done on next callback */
-         goto reloadTimerAndReturn;
-       }
-     }
-   processBit:
-    if (pSM->c.serialChar & 1)
-     {
-      pSM->txFct(swUMark_High);
-      pSM->c.nbOfBitsSet++;       /* for parity control (if needed) */
-     }
-    else
-     {
-      pSM->txFct(swUSpace_Low);
-     }
-    pSM->c.serialChar >>= 1;   /* Low Significant Bit first, so shift right 1 bit */
-    pSM->c.bitPos++;
-    goto reloadTimerAndReturn;
-   case swUTStop1:
-    if (pCfg->stop == swU2Stop)
-     {
-      pSM->state = swUTStop2;     /* 2-stop: stretch stop one bit */
-      goto reloadTimerAndReturn;
-     }
-   /* only one stop bit: NO BREAK on purpose */
-   case swUTStop2:
-    pSM->bInProgress = FALSE;   /* end of character transmission */
-    pSM->state = swUTIdle;
-    return 0;
-  }
-reloadTimerAndReturn:
- gtimerRestart(pSM->c.timerId);    /* takes advantage the timer delay never changes */
- return 0;
-}
-
-boolean swUartSendInit(byte swUartTxId, const swUartConfigurationT* pCfg, byte timerId, swUartHwSetTxFct txFct)
-{
- swUartTxStateMachineT* pSM = &_sendSArray[swUartTxId].sm;
- /* gate keeper */
- if (swUartTxId >= QTY_OF_SENDERS || pCfg == NULL || txFct == NULL)
-  {
-   return FALSE;
-  }
- if (pCfg->bitWidth < 2)
-  {
-   return FALSE;       /* cannot handle less than 2 gTimer ticks */
-  }
- /* makes sure number of bits sits within boundaries */
- if (pCfg->nbBits < MIN_BITS_SERIALIZED || pCfg->nbBits > MAX_BITS_SERIALIZED)
-  {
-   return FALSE;
-  }
- _sendSArray[swUartTxId].pCfg = pCfg;  /* hooks configuration */
- pSM->c.timerId = timerId;
- pSM->txFct = txFct;
- pSM->bInProgress = FALSE;
- pSM->state = swURIdle;
- txFct(swUMark_High);    /* sets line in mark, idle state */
- gtimerFreeze(timerId);
- /* installs callback with transmit data array reference as an immutable parameter */
- gtimerSetCallback(timerId, swUartSendCallBack, (long)_sendSArray + swUartTxId, NULL);
- return TRUE;
-}
-
-boolean swUartSendIsBusy(byte swUartTxId)
-{
- if (swUartTxId >= QTY_OF_SENDERS)
-  {
-   return TRUE;
-  }
- return _sendSArray[swUartTxId].sm.bInProgress;
-}
-
-boolean swUartSendChar(byte swUartTxId, word ch)
-{
- swUartTxStateMachineT* pSM = &_sendSArray[swUartTxId].sm;
- /* this should reasonably fail if transmission data has never been initialized */
- if (swUartTxId >= QTY_OF_SENDERS || _sendSArray[swUartTxId].pCfg == NULL || pSM->bInProgress)
-  {
-   return FALSE;
-  }
- /* primes state machine */
- pSM->bInProgress = TRUE;
- pSM->c.serialChar = ch;
- pSM->state = swUTEdge;
- /* sets the timer at one bit delay, in manual mode */
- gtimerInitAndStart(pSM->c.timerId, (dword)_sendSArray[swUartTxId].pCfg->bitWidth, FALSE);
- return TRUE;
-}
-
-boolean swUartSendData(byte swUartTxId, const void* data, word dataSize, word* pIndex)
-{
- const word* pW;
- const byte* pB;
- if (swUartTxId >= QTY_OF_SENDERS || _sendSArray[swUartTxId].pCfg == NULL || pIndex == NULL)
-  {
-   return TRUE;    /* don't pass gate-keeper: reports everything as done */
-  }
- if (swUartSendIsBusy(swUartTxId) == FALSE) /* can proceed with next char */
-  {
-   if (*pIndex == dataSize)
-    {
-     return TRUE;          /* no next char: reports as done */
-    }
-   if (_sendSArray[swUartTxId].pCfg->nbBits > 8)    /* does not fit in 8 bits  */
-    {
-     pW = (word*)data;       /* consider data buffer as composed of words */
-     swUartSendChar(swUartTxId, pW[(*pIndex)++]);
-    }
-   else       /* fits within a byte */
-    {
-     pB = (byte*)data;       /* considers data buffer accordingly */
-     swUartSendChar(swUartTxId, pB[(*pIndex)++]);
-    }
-  }
- return FALSE;
-}
-
-/************************************************************
- * reception section
- ************************************************************/
-
-static dword swUartReceiveCallBack(UNUSED_FCT_P byte id, dword value)
-{
- swUartRxStruct* pReceiveStruct = (swUartRxStruct*)value;
- swUartRxStateMachineT* pSM = &pReceiveStruct->sm;
- const swUartConfigurationT* pCfg = pReceiveStruct->pCfg;
- swUartDataStateE lineLevel;    /* stores bit level to consider */
- word timerReloadValue;
-
- if (pSM->state == swURIdle) /* should never happen */
-  {
-   return 0;
-  }
- if (pCfg->bTripleScan) /* noise canceler: scans three times 1/4 bit then waits for 1/2 bit */
-  {
-   if (pSM->rxFct() == swUMark_High)
-    {
-     pSM->scanValues++;
-    }
-   pSM->scanPosition++;
-   if (pSM->scanPosition < 3)   /* scan of one bit not finished */
-    {
-     timerReloadValue = pCfg->bitWidth >> 2;
-     goto reloadTimerAndReturn;
-    }
-   /* scan finished */
-   timerReloadValue = pCfg->bitWidth >> 1;
-   /* prepared to scan next ones */
-   pSM->scanValues = 0;
-   pSM->scanPosition = 0;
-   /* level set by majority report, will process it now */
-   lineLevel = pSM->scanValues > 1 ?  swUMark_High : swUSpace_Low;
-  }
- else    /* no noise cancellation */
-  {
-   lineLevel = pSM->rxFct();    /* just scans once */
-   timerReloadValue = pCfg->bitWidth;    /* next scan after one-bit delay */
-  }
- /* start of state machine, lineLevel and timerReloadValue defined */
- switch (pSM->state)
-  {
-   default:
-   case swURIdle:  /* should never happen because timer is stopped when so */
-    return 0;
-   case swURStart:
-    if (lineLevel != swUSpace_Low)  /* start bit has to be a a low (0), so a space */
-     {
-      pSM->error |= 1 << swUFramingError;   /* didn't get the expected start: error */
-      goto stopSM;       /* and abort reception */
-     }
-    pSM->state = swURSBit;
-    pSM->dontStore = FALSE;   /* no reason we should shun store character, if no error  */
-    pSM->c.bitPos = 0;
-    pSM->c.nbOfBitsSet = 0;   /* for parity */
-    pSM->c.serialChar = 0;   /* char will be stored here */
-    goto reloadTimerAndReturn;
-   case swURSBit:
-    if (lineLevel == swUMark_High)
-     {
-      pSM->c.nbOfBitsSet++;       /* for parity */
-      pSM->c.serialChar |= 1 << pSM->c.bitPos;   /* Least Significant Bit first */
-     }
-    if (++pSM->c.bitPos >= pCfg->nbBits) /* reached required number of bits then stop bit if no parity or parity check */
-     {
-      if (pCfg->parity == swUNoParity)
-       {
-        pSM->state = swURStop1;
-       }
-      else
-       {
-        pSM->state = swURParity;
-       }
-     }
-    goto reloadTimerAndReturn;
-   case swURParity:
-    if (pSM->c.nbOfBitsSet & 1)  /* odd number of bits set */
-     {
-      /* if parity is even logic should be high (1), so line should be mark */
-      if (lineLevel != ((pCfg->parity == swUEvenParity) ? swUMark_High : swUSpace_Low))
-       {
-        pSM->error |= 1 << swUParityError;
-        pSM->dontStore = TRUE;
-       }
-     }
-    else     /* even number of bits set */
-     {
-      /* if parity is even logic should be low (0), so line should be space */
-      if (lineLevel != ((pCfg->parity == swUEvenParity) ? swUSpace_Low : swUMark_High))
-       {
-        pSM->error |= 1 << swUParityError;
-        pSM->dontStore = TRUE;
-       }
-     }
-    pSM->state = swURStop1;
-    goto reloadTimerAndReturn;
-   case swURStop1:
-    if (lineLevel != swUMark_High)
-     {
-      pSM->error |= 1 << swUFramingError;
-      pSM->dontStore = TRUE;
-     }
-    if (pCfg->stop == swU1Stop)
-     {
-      goto storeValueStage;
-     }
-    pSM->state = swURStop2;
-    goto reloadTimerAndReturn;
-   case swURStop2:
-    if (pSM->rxFct() != swUMark_High)
-     {
-      pSM->error |= 1 << swUFramingError;
-      pSM->dontStore = TRUE;
-     }
-   storeValueStage:
-    if (pSM->dontStore == FALSE)
-     {
-      /* stores value in the FIFO */
-      byte newIndex = (pSM->rxFifoWriteIndex + 1) & RCPT_FIFO_SIZE_MASK; /* useful to pre-calculate new write index in case of overrun */
-      pSM->rxFifo[pSM->rxFifoWriteIndex] = (RCPT_FIFO_TYPE)pSM->c.serialChar;
-      if (pSM->rxFifoEmpty == FALSE)
-       {
-        if (pSM->rxFifoWriteIndex == pSM->rxFifoReadIndex)      /* ouch, overrun */
-         {
-          pSM->error |= 1 << swUOverrunError;
-          pSM->rxFifoReadIndex = newIndex;         /* one character lost */
-         }
-       }
-      pSM->rxFifoWriteIndex = newIndex;
-      pSM->rxFifoEmpty = FALSE;     /* never can be empty, obviously */
-     }
-   stopSM:
-    pSM->bInProgress = FALSE;
-    pSM->state = swURIdle;   /* timer is manual, so the state machine will stop here */
-    return 0;
-  }
-reloadTimerAndReturn:
- /* timer is manual, so we reload it here */
- gtimerInitAndStart(pSM->c.timerId,
-                    (dword)timerReloadValue,
-                    FALSE);
- return 0;
-}
-
-boolean swUartReceiveInit(byte swUartRxId, const swUartConfigurationT* pCfg, byte timerId, swUartHwGetRxFct rxFct)
-{
- swUartRxStateMachineT* pSM = &_receiveSArray[swUartRxId].sm;
- if (swUartRxId >= QTY_OF_RECEIVERS || pCfg == NULL || rxFct == NULL)
-  {
-   return FALSE;
-  }
- if (pCfg->bTripleScan) /* noise canceler */
-  {
-   if ((pCfg->bitWidth & (2 * 4 - 1)) != 0) /* x2 because of gTimer minimum delay */
-    {
-     return FALSE;         /* cannot handle 1/4 bit delay: error */
-    }
-  }
- else    /* no noise canceler */
-  {
-   if ((pCfg->bitWidth & (2 * 2 - 1)) != 0) /* x2 because of gTimer minimum delay */
-    {
-     return FALSE;          /* cannot handle 1/2 bit delay: error */
-    }
-  }
- /* makes sure number of bits sits within boundaries */
- if (pCfg->nbBits < MIN_BITS_SERIALIZED || pCfg->nbBits > MAX_BITS_SERIALIZED)
-  {
-   return FALSE;
-  }
- _receiveSArray[swUartRxId].pCfg = pCfg;
- pSM->c.timerId = timerId;
- pSM->bInProgress = FALSE;
- /* error only reset automatically here */
- pSM->error = 0;
- pSM->rxFct = rxFct;
- pSM->rxFifoEmpty = TRUE;
- pSM->rxFifoReadIndex = pSM->rxFifoWriteIndex = 0;
- pSM->state = swURIdle;
- gtimerFreeze(timerId);
- /* installs callback with transmit data array reference as an immutable parameter */
- gtimerSetCallback(timerId, swUartReceiveCallBack, (long)_receiveSArray + swUartRxId, NULL);
- return TRUE;
-}
-
-boolean swUartReceiveScanForStart(byte swUartRxId)
-{
- swUartRxStateMachineT* pSM = &_receiveSArray[swUartRxId].sm;
- const swUartConfigurationT* pCfg = _receiveSArray[swUartRxId].pCfg;
- if (swUartRxId >= QTY_OF_RECEIVERS)
-  {
-   return FALSE;
-  }
- if (pSM->bInProgress == FALSE && pSM->rxFct() == swUSpace_Low) /* detected a space on the line: Low (0) */
-  {
-   pSM->bInProgress = TRUE;
-   pSM->state = swURStart;
-   if (pCfg->bTripleScan)
-    {
-     pSM->scanValues = 0;   /* will store different samples scanned */
-     pSM->scanPosition = 0;   /* will count them */
-    }
-   /* sets timer to scan next center bit with or 1/4 of bit duration in case of noise cancellation
-      this will start the reception state machine */
-   gtimerInitAndStart(pSM->c.timerId,
-                      (dword)(pCfg->bitWidth >> (pCfg->bTripleScan ? 2 : 1)),
-                      FALSE);
-   return TRUE;       /* reports a reception under progress */
-  }
- return FALSE;
-}
-
-word swUartPeekChar(byte swUartRxId)
-{
- swUartRxStateMachineT* pSM = &_receiveSArray[swUartRxId].sm;
- if (swUartRxId >= QTY_OF_RECEIVERS || pSM->rxFifoEmpty)
-  {
-   return 0xffff;
-  }
- return (word)pSM->rxFifo[pSM->rxFifoReadIndex];
-}
-
-word swUartGetChar(byte swUartRxId)
-{
- byte readIndex;
- swUartRxStateMachineT* pSM = &_receiveSArray[swUartRxId].sm;
- if (swUartRxId >= QTY_OF_RECEIVERS || pSM->rxFifoEmpty)
-  {
-   return 0xffff;
-  }
- readIndex = pSM->rxFifoReadIndex;  /* snaps index before increment it */
- pSM->rxFifoReadIndex = (pSM->rxFifoReadIndex + 1) & RCPT_FIFO_SIZE_MASK;
- if (pSM->rxFifoReadIndex == pSM->rxFifoWriteIndex) /* FIFO dried out */
-  {
-   pSM->rxFifoReadIndex = pSM->rxFifoWriteIndex = 0;
-   pSM->rxFifoEmpty = TRUE;
-  }
- return (word)pSM->rxFifo[readIndex];
-}
-
-byte swUartHowManyChars(byte swUartRxId)
-{
- swUartRxStateMachineT* pSM = &_receiveSArray[swUartRxId].sm;
- int ret;
- if (swUartRxId >= QTY_OF_RECEIVERS || pSM->rxFifoEmpty)
-  {
-   return 0;
-  }
- /* we suppose write is ahead of read in the FIFO */
- ret = pSM->rxFifoWriteIndex - pSM->rxFifoReadIndex;
- if (ret <= 0) /* nope */
-  {
-   ret = (int)RCPT_FIFO_SIZE - ret;  /* so corrects by 'unfolding' the FIFO index */
-  }
- return (byte)ret;
-}
-
-word swUartPeekNChar(byte swUartRxId, byte nth)
-{
- if (nth < swUartHowManyChars(swUartRxId))
-  {
-   swUartRxStateMachineT* pSM = &_receiveSArray[swUartRxId].sm;
-   /* as nth fits a simple modulo operation can reach it: char at index (readIndex+nth) % RCPT_FIFO_SIZE  */
-   return (word)pSM->rxFifo[(pSM->rxFifoReadIndex + nth) & RCPT_FIFO_SIZE_MASK];
-  }
- return 0xffff;
-}
-
-void swUartFlushChars(byte swUartRxId)
-{
- if (swUartRxId < QTY_OF_RECEIVERS)
-  {
-   swUartRxStateMachineT* pSM = &_receiveSArray[swUartRxId].sm;
-   pSM->rxFifoReadIndex = pSM->rxFifoWriteIndex = 0;
-   pSM->rxFifoEmpty = TRUE;
-  }
-}
-
-byte swUartReceiveGetAndClearError(byte swUartRxId, boolean bClearError)
-{
- byte error;
- if (swUartRxId >= QTY_OF_RECEIVERS)
-  {
-   return 0;
-  }
- error = _receiveSArray[swUartRxId].sm.error;
- if (bClearError)
-  {
-   _receiveSArray[swUartRxId].sm.error = 0;
-  }
- return error;
-}
+#include <string.h>
+
+#include "swUart.h"
+
+#include "gtimer.h"
+#ifdef SWUART_IMPLEMENTS_TRACE
+ #include "trace.h"
+#endif
+
+#define QTY_OF_SENDERS (1)
+#define QTY_OF_RECEIVERS (1)
+
+#define MIN_BITS_SERIALIZED (3)
+#define MAX_BITS_SERIALIZED (10)
+
+/* events of a transmitter or receiver in the trace ring: states are recorded with the bit they are on */
+#ifdef SWUART_IMPLEMENTS_TRACE
+ #define TRACE(event, unit, arg) traceRecord(event, (byte)(unit), (word)(arg))
+ #define TRACE_STATE(event, unit, pSM) TRACE(event, unit, (pSM)->state | (pSM)->c.bitPos << 8)
+ #define TRACE_TX(unit, level) TRACE(traceSwUartTxState, unit, (level) == CHAR_SENT ? swUTIdle : swUTSpace + (level))
+#else
+ #define TRACE(event, unit, arg)
+ #define TRACE_STATE(event, unit, pSM)
+ #define TRACE_TX(unit, level)
+#endif
+
+#ifndef SWUART_ENTER_CRITICAL /* should mask the interrupt running gTimer callbacks, if any */
+ #define SWUART_ENTER_CRITICAL()
+ #define SWUART_EXIT_CRITICAL()
+#endif
+
+/* a reception FIFO has one producer, its receiver, and one consumer, its reader, possibly on different cores:
+   each index is written by one side only and published with release semantics, errors are set and taken
+   atomically */
+#ifdef __GNUC__
+ #define LOAD_ACQUIRE(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+ #define STORE_RELEASE(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+ #define SET_ERROR(p, bits) ((void)__atomic_fetch_or(p, (byte)(bits), __ATOMIC_RELAXED))
+ #define TAKE_ERROR(p) __atomic_exchange_n(p, 0, __ATOMIC_RELAXED)
+#else
+ #define LOAD_ACQUIRE(p) (*(volatile dword*)(p))
+ #define STORE_RELEASE(p, v) (*(volatile dword*)(p) = (v))
+ #define SET_ERROR(p, bits) (*(volatile byte*)(p) |= (bits))
+ #define TAKE_ERROR(p) take_Error(p)
+#endif
+
+/* what send_Bit returns when it does not set the line to swUSpace_Low or swUMark_High */
+#define CHAR_SENT (2)        /* end of character: line stays in mark */
+
+/* duration of one bit in 256ths of a tick */
+#define BIT_STEP(pCfg) ((dword)(pCfg)->bitWidth << 8 | (pCfg)->bitWidthFraction)
+
+/* bits of a character: start, data, parity and stop bits */
+#define FRAME_BITS(pCfg) (1 + (pCfg)->nbBits + ((pCfg)->parity != swUNoParity) + ((pCfg)->stop == swU2Stop ? 2 : 1))
+
+/* steps of the measure of the bit width of a receiver in autobaud mode */
+typedef enum { swUABFirstEdge, swUABShortest, swUABValidate, swUABIdle } swUartAutobaudStepE;
+
+/* parity of each nibble value as a 16-bit map: bit n is set when n has an odd number of bits set */
+#define NIBBLE_PARITY_MAP (0x6996)
+
+/* arrays of transmitter and receiver data structures */
+static swUartTxChannelT _sendSArray[QTY_OF_SENDERS];
+static swUartRxChannelT _receiveSArray[QTY_OF_RECEIVERS];
+
+/************************************************************
+ * transmission section
+ ************************************************************/
+
+/* advances a transmission state machine by one bit: returns the level to set the line to, or CHAR_SENT
+   the frame was built by start_Char, first bit to send in the lsb: the last stop bit being a mark, the
+   shift register only gets to 0 once the whole frame is out */
+static byte send_Bit(swUartTxStateMachineT* pSM)
+{
+ word frame = pSM->c.serialChar;
+
+ if (frame == 0)
+  {
+   pSM->bInProgress = FALSE;
+   return CHAR_SENT;
+  }
+ pSM->c.serialChar = frame >> 1;
+ return (byte)(frame & 1);
+}
+
+/* ticks of a delay given in 256ths of a tick: fractions left over are carried to the next delay (Bresenham), so that
+   delays of a whole number of ticks add up to the exact duration of bits */
+static dword next_Delay(byte* pCarry, dword step)
+{
+ step += *pCarry;
+ *pCarry = (byte)step;
+ return step >> 8;
+}
+
+/* checks a transmission configuration and hooks it */
+static boolean init_Sender(swUartTxChannelT* pSendStruct, const swUartConfigurationT* pCfg)
+{
+ if (pCfg == NULL)
+  {
+   return FALSE;
+  }
+ if (pCfg->bitWidth < 2)
+  {
+   return FALSE;       /* cannot handle less than 2 gTimer ticks */
+  }
+ /* makes sure number of bits sits within boundaries */
+ if (pCfg->nbBits < MIN_BITS_SERIALIZED || pCfg->nbBits > MAX_BITS_SERIALIZED)
+  {
+   return FALSE;
+  }
+ pSendStruct->pCfg = pCfg;  /* hooks configuration */
+ pSendStruct->sm.bInProgress = FALSE;
+ pSendStruct->pFirstBlock = pSendStruct->pLastBlock = NULL;
+ return TRUE;
+}
+
+/* 1 if bits of a character (up to 16) have an odd number of marks */
+static byte odd_Parity(word bits)
+{
+ bits ^= bits >> 8;
+ bits ^= bits >> 4;
+ return (byte)(NIBBLE_PARITY_MAP >> (bits & 0xf) & 1);
+}
+
+/* primes a transmission state machine with the frame of a character, sent lsb first:
+   start bit (space), data bits, parity bit if any, stop bits (mark) */
+static boolean start_Char(swUartTxChannelT* pSendStruct, word ch)
+{
+ swUartTxStateMachineT* pSM = &pSendStruct->sm;
+ const swUartConfigurationT* pCfg = pSendStruct->pCfg;
+ byte length;
+ /* this should reasonably fail if transmission data has never been initialized */
+ if (pCfg == NULL || pSM->bInProgress)
+  {
+   return FALSE;
+  }
+ ch &= (1 << pCfg->nbBits) - 1;
+ length = 1 + pCfg->nbBits;
+ pSM->c.serialChar = ch << 1;
+ if (pCfg->parity != swUNoParity)
+  {
+   /* parity bit is a mark when it takes one to make the number of marks even (or odd) */
+   pSM->c.serialChar |= (word)(odd_Parity(ch) ^ (pCfg->parity == swUOddParity)) << length++;
+  }
+ pSM->c.serialChar |= (pCfg->stop == swU2Stop ? 3 : 1) << length;
+ pSM->bInProgress = TRUE;
+ return TRUE;
+}
+
+/* takes the next character of the queue of blocks of a transmitter into its frame: FALSE if the queue is empty */
+static boolean pull_Char(swUartTxChannelT* pSendStruct)
+{
+ swUartTxBlockT* pBlock = pSendStruct->pFirstBlock;
+ word index, ch;
+
+ if (pBlock == NULL)
+  {
+   return FALSE;
+  }
+ index = pBlock->index;
+ if (pSendStruct->pCfg->nbBits > 8)
+  {
+   ch = ((const word*)pBlock->data)[index];
+  }
+ else
+  {
+   ch = ((const byte*)pBlock->data)[index];
+  }
+ if (index + 1 == pBlock->size)    /* last character: the block goes back to its owner */
+  {
+   SWUART_ENTER_CRITICAL();
+   pSendStruct->pFirstBlock = pBlock->pNext;
+   if (pSendStruct->pFirstBlock == NULL)
+    {
+     pSendStruct->pLastBlock = NULL;
+    }
+   SWUART_EXIT_CRITICAL();
+  }
+ start_Char(pSendStruct, ch);
+ pBlock->index = index + 1;
+ return TRUE;
+}
+
+/* links a block at the end of the queue of a transmitter: TRUE if the transmitter was idle and has been primed
+   with its first character, so that it has to be started */
+static boolean queue_Block(swUartTxChannelT* pSendStruct, swUartTxBlockT* pBlock)
+{
+ boolean bIdle;
+
+ if (pBlock->index >= pBlock->size)
+  {
+   return FALSE;    /* nothing to send */
+  }
+ pBlock->pNext = NULL;
+ SWUART_ENTER_CRITICAL();
+ if (pSendStruct->pLastBlock == NULL)
+  {
+   pSendStruct->pFirstBlock = pBlock;
+  }
+ else
+  {
+   pSendStruct->pLastBlock->pNext = pBlock;
+  }
+ pSendStruct->pLastBlock = pBlock;
+ bIdle = pSendStruct->sm.bInProgress == FALSE;
+ SWUART_EXIT_CRITICAL();
+ if (bIdle == FALSE)
+  {
+   return FALSE;
+  }
+ /* once idle, only this very call can take from the queue */
+ pSendStruct->countdown = 1;    /* in a group: start bit on next tick */
+ return pull_Char(pSendStruct);
+}
+
+static dword swUartSendCallBack(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ swUartTxChannelT* pSendStruct = (swUartTxChannelT*)value;
+ byte level = send_Bit(&pSendStruct->sm);
+
+ if (level == CHAR_SENT && pull_Char(pSendStruct))
+  {
+   level = send_Bit(&pSendStruct->sm);    /* start bit of the next character, right as the stop bit ends */
+  }
+ TRACE_TX(pSendStruct - _sendSArray, level);
+ if (level == CHAR_SENT)
+  {
+   return GTIMER_CALLBACK_STOP;
+  }
+ pSendStruct->sm.txFct((swUartDataStateE)level);
+ return next_Delay(&pSendStruct->sm.c.carry, BIT_STEP(pSendStruct->pCfg));    /* gTimer rearms for one more bit */
+}
+
+boolean swUartSendInit(byte swUartTxId, const swUartConfigurationT* pCfg, byte timerId, swUartHwSetTxFct txFct)
+{
+ swUartTxStateMachineT* pSM = &_sendSArray[swUartTxId].sm;
+ /* gate keeper */
+ if (swUartTxId >= QTY_OF_SENDERS || txFct == NULL || init_Sender(&_sendSArray[swUartTxId], pCfg) == FALSE)
+  {
+   return FALSE;
+  }
+ pSM->c.timerId = timerId;
+ pSM->txFct = txFct;
+ txFct(swUMark_High);    /* sets line in mark, idle state */
+ gtimerFreeze(timerId);
+ /* installs callback with transmit data array reference as an immutable parameter */
+ gtimerSetRearmCallback(timerId, swUartSendCallBack, (long)_sendSArray + swUartTxId);
+ return TRUE;
+}
+
+boolean swUartSendIsBusy(byte swUartTxId)
+{
+ if (swUartTxId >= QTY_OF_SENDERS)
+  {
+   return TRUE;
+  }
+ return _sendSArray[swUartTxId].sm.bInProgress;
+}
+
+boolean swUartSendChar(byte swUartTxId, word ch)
+{
+ swUartTxStateMachineT* pSM = &_sendSArray[swUartTxId].sm;
+ if (swUartTxId >= QTY_OF_SENDERS || start_Char(&_sendSArray[swUartTxId], ch) == FALSE)
+  {
+   return FALSE;
+  }
+ /* sets the timer at one bit delay, in manual mode */
+ pSM->c.carry = 0;
+ gtimerInitAndStart(pSM->c.timerId, next_Delay(&pSM->c.carry, BIT_STEP(_sendSArray[swUartTxId].pCfg)), FALSE);
+ return TRUE;
+}
+
+boolean swUartSendBlock(byte swUartTxId, swUartTxBlockT* pBlock)
+{
+ swUartTxChannelT* pSendStruct = &_sendSArray[swUartTxId];
+ if (swUartTxId >= QTY_OF_SENDERS || pSendStruct->pCfg == NULL || pBlock == NULL)
+  {
+   return FALSE;
+  }
+ if (queue_Block(pSendStruct, pBlock))
+  {
+   /* sets the timer at one bit delay, in manual mode, as swUartSendChar does */
+   pSendStruct->sm.c.carry = 0;
+   gtimerInitAndStart(pSendStruct->sm.c.timerId, next_Delay(&pSendStruct->sm.c.carry, BIT_STEP(pSendStruct->pCfg)), FALSE);
+  }
+ return TRUE;
+}
+
+boolean swUartSendData(byte swUartTxId, const void* data, word dataSize, word* pIndex)
+{
+ const word* pW;
+ const byte* pB;
+ if (swUartTxId >= QTY_OF_SENDERS || _sendSArray[swUartTxId].pCfg == NULL || pIndex == NULL)
+  {
+   return TRUE;    /* don't pass gate-keeper: reports everything as done */
+  }
+ if (swUartSendIsBusy(swUartTxId) == FALSE) /* can proceed with next char */
+  {
+   if (*pIndex == dataSize)
+    {
+     return TRUE;          /* no next char: reports as done */
+    }
+   if (_sendSArray[swUartTxId].pCfg->nbBits > 8)    /* does not fit in 8 bits  */
+    {
+     pW = (word*)data;       /* consider data buffer as composed of words */
+     swUartSendChar(swUartTxId, pW[(*pIndex)++]);
+    }
+   else       /* fits within a byte */
+    {
+     pB = (byte*)data;       /* considers data buffer accordingly */
+     swUartSendChar(swUartTxId, pB[(*pIndex)++]);
+    }
+  }
+ return FALSE;
+}
+
+/************************************************************
+ * reception section
+ ************************************************************/
+
+/* stores a received character in a FIFO, on the receiver side: it is lost if the FIFO is full (returns FALSE) */
+static boolean push_Char(swUartRxFifoT* pFifo, word ch, UNUSED_FCT_P word unit)
+{
+ dword writeIndex = pFifo->rxFifoWriteIndex;    /* only written here */
+
+ if (writeIndex - LOAD_ACQUIRE(&pFifo->rxFifoReadIndex) > pFifo->rxFifoSizeMask)    /* ouch, overrun */
+  {
+   SET_ERROR(&pFifo->error, 1 << swUOverrunError);
+   TRACE(traceSwUartError, unit, 1 << swUOverrunError);
+   return FALSE;
+  }
+ pFifo->rxFifo[writeIndex & pFifo->rxFifoSizeMask] = (RCPT_FIFO_TYPE)ch;
+ STORE_RELEASE(&pFifo->rxFifoWriteIndex, writeIndex + 1);    /* publishes the character */
+ TRACE(traceSwUartFifoPush, unit, ch);
+ return TRUE;
+}
+
+#ifndef __GNUC__
+/* reads and clears the error of a FIFO, on the reader side */
+static byte take_Error(byte* pError)
+{
+ byte error;
+
+ SWUART_ENTER_CRITICAL();
+ error = *pError;
+ *pError = 0;
+ SWUART_EXIT_CRITICAL();
+ return error;
+}
+#endif
+
+/* empties a FIFO and sets its built-in storage back, clearing its error */
+static void init_Fifo(swUartRxFifoT* pFifo)
+{
+ pFifo->error = 0;
+ pFifo->rxFifo = pFifo->rxFifoBuiltIn;
+ pFifo->rxFifoSizeMask = RCPT_FIFO_SIZE_MASK;
+ pFifo->rxFifoReadIndex = pFifo->rxFifoWriteIndex = 0;
+}
+
+/* makes a FIFO use storage of a given size, a power of 2: it is emptied */
+static boolean set_Fifo(swUartRxFifoT* pFifo, RCPT_FIFO_TYPE* storage, dword size)
+{
+ if (storage == NULL || size == 0 || size > SWUART_MAX_FIFO_SIZE || (size & (size - 1)) != 0)
+  {
+   return FALSE;
+  }
+ pFifo->rxFifoReadIndex = pFifo->rxFifoWriteIndex = 0;
+ pFifo->rxFifo = storage;
+ pFifo->rxFifoSizeMask = (word)(size - 1);
+ return TRUE;
+}
+
+/* reports an error of the character being received */
+static void set_RxError(swUartRxStateMachineT* pSM, swUartErrorBitDefinitionE error, UNUSED_FCT_P word unit)
+{
+ SET_ERROR(&pSM->f.error, 1 << error);
+ TRACE(traceSwUartError, unit, 1 << error);
+ pSM->errors |= 1 << error;
+}
+
+/* in multidrop mode, an address (last data bit set) selects the receiver or not: returns FALSE if the character is not
+   for it */
+static boolean select_Char(swUartRxStateMachineT* pSM, const swUartConfigurationT* pCfg)
+{
+ const word addressBit = (word)(1 << (pCfg->nbBits - 1));
+
+ if (pSM->c.serialChar & addressBit)
+  {
+   pSM->bSelected = pSM->dontStore == FALSE && ((pSM->c.serialChar ^ pSM->address) & pSM->addressMask & (addressBit - 1)) == 0;
+  }
+ return pSM->bSelected;
+}
+
+/* sets the multidrop mode of a receiver, which is not selected until an address selects it */
+static boolean set_Address(swUartRxStateMachineT* pSM, const swUartConfigurationT* pCfg, boolean bMultidrop, word address,
+                           word mask)
+{
+ if (pCfg == NULL)
+  {
+   return FALSE;
+  }
+ SWUART_ENTER_CRITICAL();    /* bit fields shared with the receiver */
+ pSM->address = address;
+ pSM->addressMask = mask;
+ pSM->bSelected = FALSE;
+ pSM->bMultidrop = bMultidrop != FALSE;
+ SWUART_EXIT_CRITICAL();
+ return TRUE;
+}
+
+/* advances a reception state machine with the level of the line in the middle of a bit:
+   returns FALSE when the character is over (stored or not) */
+static boolean receive_Level(swUartRxStateMachineT* pSM, const swUartConfigurationT* pCfg, swUartDataStateE lineLevel,
+                             UNUSED_FCT_P word unit)
+{
+ switch (pSM->state)
+  {
+   default:
+   case swURIdle:  /* should never happen because timer is stopped when so */
+    return FALSE;
+   case swURStart:
+    if (lineLevel != swUSpace_Low)  /* start bit has to be a a low (0), so a space */
+     {
+      set_RxError(pSM, swUFramingError, unit);   /* didn't get the expected start: error */
+      goto stopSM;       /* and abort reception */
+     }
+    pSM->state = swURSBit;
+    pSM->dontStore = FALSE;   /* no reason we should shun store character, if no error  */
+    pSM->c.bitPos = 0;
+    pSM->c.nbOfBitsSet = 0;   /* for parity */
+    pSM->c.serialChar = 0;   /* char will be stored here */
+    break;
+   case swURSBit:
+    if (lineLevel == swUMark_High)
+     {
+      pSM->c.nbOfBitsSet++;       /* for parity */
+      pSM->c.serialChar |= 1 << pSM->c.bitPos;   /* Least Significant Bit first */
+     }
+    if (++pSM->c.bitPos >= pCfg->nbBits) /* reached required number of bits then stop bit if no parity or parity check */
+     {
+      if (pCfg->parity == swUNoParity)
+       {
+        pSM->state = swURStop1;
+       }
+      else
+       {
+        pSM->state = swURParity;
+       }
+     }
+    break;
+   case swURParity:
+    if (pSM->c.nbOfBitsSet & 1)  /* odd number of bits set */
+     {
+      /* if parity is even logic should be high (1), so line should be mark */
+      if (lineLevel != ((pCfg->parity == swUEvenParity) ? swUMark_High : swUSpace_Low))
+       {
+        set_RxError(pSM, swUParityError, unit);
+        pSM->dontStore = TRUE;
+       }
+     }
+    else     /* even number of bits set */
+     {
+      /* if parity is even logic should be low (0), so line should be space */
+      if (lineLevel != ((pCfg->parity == swUEvenParity) ? swUSpace_Low : swUMark_High))
+       {
+        set_RxError(pSM, swUParityError, unit);
+        pSM->dontStore = TRUE;
+       }
+     }
+    pSM->state = swURStop1;
+    break;
+   case swURStop1:
+    if (lineLevel != swUMark_High)
+     {
+      set_RxError(pSM, swUFramingError, unit);
+      pSM->dontStore = TRUE;
+     }
+    if (pCfg->stop == swU1Stop)
+     {
+      goto storeValueStage;
+     }
+    pSM->state = swURStop2;
+    break;
+   case swURStop2:
+    if (lineLevel != swUMark_High)
+     {
+      set_RxError(pSM, swUFramingError, unit);
+      pSM->dontStore = TRUE;
+     }
+   storeValueStage:
+    if (pSM->bMultidrop && select_Char(pSM, pCfg) == FALSE)
+     {
+      pSM->dontStore = TRUE;    /* addressed to another node */
+     }
+    if (pSM->dontStore == FALSE && push_Char(&pSM->f, pSM->c.serialChar, unit) == FALSE)
+     {
+      pSM->errors |= 1 << swUOverrunError;
+     }
+   stopSM:
+    pSM->bInProgress = FALSE;
+    pSM->state = swURIdle;   /* the state machine will stop here */
+    TRACE_STATE(traceSwUartRxState, unit, pSM);
+    return FALSE;
+  }
+ TRACE_STATE(traceSwUartRxState, unit, pSM);
+ return TRUE;
+}
+
+/* ends the reception of a character, stored or not, or of a glitch: the timer stops, unless the receiver delimits
+   frames and one is going on, the timer then timing the silence which closes it (from the middle of the last stop bit)
+   until swUartReceiveScanForStart restarts it on a next start bit */
+static dword end_Reception(swUartRxChannelT* pReceiveStruct)
+{
+ const swUartConfigurationT* pCfg = pReceiveStruct->pCfg;
+ swUartRxStateMachineT* pSM = &pReceiveStruct->sm;
+ dword silence;
+
+ pReceiveStruct->frameErrors |= pSM->errors;
+ pSM->errors = 0;
+ if (pReceiveStruct->frames == NULL ||
+     (pSM->f.rxFifoWriteIndex == pReceiveStruct->frameFirst && pReceiveStruct->frameErrors == 0))
+  {
+   return GTIMER_CALLBACK_STOP;
+  }
+ /* in 16ths of a tick, so as not to overflow */
+ silence = (dword)FRAME_BITS(pCfg) * pReceiveStruct->idleTenths * (BIT_STEP(pCfg) >> 4) / 10 - (BIT_STEP(pCfg) >> 5);
+ return silence >> 4 < 2 ? 2 : silence >> 4;
+}
+
+/* closes the frame going on once the line has been idle long enough: it is lost if the queue is full */
+static void close_Frame(swUartRxChannelT* pReceiveStruct, UNUSED_FCT_P word unit)
+{
+ swUartRxStateMachineT* pSM = &pReceiveStruct->sm;
+ dword writeIndex = pReceiveStruct->frameWriteIndex;    /* only written here */
+ dword last = pSM->f.rxFifoWriteIndex;
+ swUartFrameT* pFrame;
+
+ if (writeIndex - LOAD_ACQUIRE(&pReceiveStruct->frameReadIndex) > pReceiveStruct->framesSizeMask)
+  {
+   SET_ERROR(&pSM->f.error, 1 << swUOverrunError);
+   TRACE(traceSwUartError, unit, 1 << swUOverrunError);
+  }
+ else
+  {
+   pFrame = &pReceiveStruct->frames[writeIndex & pReceiveStruct->framesSizeMask];
+   pFrame->start = pReceiveStruct->frameFirst;
+   pFrame->length = last - pReceiveStruct->frameFirst;
+   pFrame->errors = pReceiveStruct->frameErrors;
+   STORE_RELEASE(&pReceiveStruct->frameWriteIndex, writeIndex + 1);    /* publishes the frame */
+   TRACE(traceSwUartFrame, unit, pFrame->length);
+  }
+ pReceiveStruct->frameFirst = last;
+ pReceiveStruct->frameErrors = 0;
+}
+
+static dword swUartReceiveCallBack(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ swUartRxChannelT* pReceiveStruct = (swUartRxChannelT*)value;
+ swUartRxStateMachineT* pSM = &pReceiveStruct->sm;
+ const swUartConfigurationT* pCfg = pReceiveStruct->pCfg;
+ swUartDataStateE lineLevel = pSM->rxFct();    /* stores bit level to consider */
+ byte phase;
+
+ if (pSM->state == swURIdle) /* the line has been idle long enough since the last character: closes its frame */
+  {
+   close_Frame(pReceiveStruct, pReceiveStruct - _receiveSArray);
+   return GTIMER_CALLBACK_STOP;
+  }
+ if (pReceiveStruct->samplesPerBit == 0)    /* no noise cancellation: just scans once, in the middle of the bit */
+  {
+   if (receive_Level(pSM, pCfg, lineLevel, pReceiveStruct - _receiveSArray) == FALSE)
+    {
+     return end_Reception(pReceiveStruct);    /* timer is manual, so the state machine will stop here */
+    }
+   return next_Delay(&pSM->c.carry, BIT_STEP(pCfg));    /* next scan after one-bit delay */
+  }
+ /* oversampling: one sample per call, sample 0 of a bit being on its edge */
+ phase = pSM->scanPosition + 1;
+ if (phase == pReceiveStruct->samplesPerBit)
+  {
+   phase = 0;
+  }
+ if (lineLevel == swUSpace_Low && pSM->lastSample == swUMark_High &&
+     (phase < pReceiveStruct->windowFirst || phase > pReceiveStruct->windowLast))
+  {
+   phase = 0;    /* a bit begins here, sooner or later than expected: resynchronizes on it */
+  }
+ pSM->lastSample = lineLevel;
+ pSM->scanPosition = phase;
+ if (phase < pReceiveStruct->windowFirst || phase > pReceiveStruct->windowLast)
+  {
+   if (pSM->state == swURStart && lineLevel == swUMark_High)    /* start bit was a glitch: back to idle */
+    {
+     pSM->bInProgress = FALSE;
+     pSM->state = swURIdle;
+     TRACE_STATE(traceSwUartRxState, pReceiveStruct - _receiveSArray, pSM);
+     return end_Reception(pReceiveStruct);
+    }
+   return next_Delay(&pSM->c.carry, pReceiveStruct->sampleStep);
+  }
+ if (lineLevel == swUMark_High)
+  {
+   pSM->scanValues++;
+  }
+ if (phase < pReceiveStruct->windowLast)   /* scan of one bit not finished */
+  {
+   return next_Delay(&pSM->c.carry, pReceiveStruct->sampleStep);
+  }
+ /* level set by majority report, will process it now */
+ lineLevel = pSM->scanValues > (pReceiveStruct->windowLast - pReceiveStruct->windowFirst) / 2 ?
+             swUMark_High : swUSpace_Low;
+ pSM->scanValues = 0;
+ if (receive_Level(pSM, pCfg, lineLevel, pReceiveStruct - _receiveSArray) == FALSE)
+  {
+   return end_Reception(pReceiveStruct);
+  }
+ /* timer is manual, so gTimer reloads it with the returned value */
+ return next_Delay(&pSM->c.carry, pReceiveStruct->sampleStep);
+}
+
+/* smallest bit width of a receiver, in ticks: twice a sample, because of gTimer minimum delay, a sample being half a
+   bit without noise canceler; 0 if noise canceler parameters are wrong */
+static word min_Width(const swUartConfigurationT* pCfg)
+{
+ byte samples = pCfg->oversampling != 0 ? pCfg->oversampling : pCfg->bTripleScan ? 4 : 2;
+ byte window = pCfg->oversampling != 0 && pCfg->majorityWindow != 0 ? pCfg->majorityWindow : 3;
+
+ if ((pCfg->oversampling != 0 || pCfg->bTripleScan) &&
+     ((samples != 4 && samples != 8 && samples != 16) || (window & 1) == 0 || window >= samples))
+  {
+   return 0;
+  }
+ return 2 * samples;
+}
+
+/* checks the bit width of a configuration and computes the timings of a receiver from it */
+static boolean time_Receiver(swUartRxChannelT* pReceiveStruct, const swUartConfigurationT* pCfg)
+{
+ word minWidth = min_Width(pCfg);
+ byte samples, window;
+
+ if (minWidth == 0 || pCfg->bitWidth < minWidth)
+  {
+   return FALSE;         /* cannot handle 1/samples bit delay: error */
+  }
+ pReceiveStruct->samplesPerBit = 0;
+ if (pCfg->oversampling != 0 || pCfg->bTripleScan) /* noise canceler */
+  {
+   /* triple scan: scans three times 1/4 bit, the 4th sample only looks for edges */
+   samples = (byte)(minWidth / 2);
+   window = pCfg->oversampling != 0 && pCfg->majorityWindow != 0 ? pCfg->majorityWindow : 3;
+   /* samples of the window are centered on the middle of the bit */
+   pReceiveStruct->sampleStep = BIT_STEP(pCfg) / samples;
+   pReceiveStruct->windowFirst = samples / 2 - window / 2;
+   pReceiveStruct->windowLast = pReceiveStruct->windowFirst + window - 1;
+   pReceiveStruct->samplesPerBit = samples;
+  }
+ return TRUE;
+}
+
+/* checks common reception rules and hooks configuration, with an empty FIFO */
+static boolean init_Receiver(swUartRxChannelT* pReceiveStruct, const swUartConfigurationT* pCfg)
+{
+ swUartRxStateMachineT* pSM = &pReceiveStruct->sm;
+ if (pCfg == NULL)
+  {
+   return FALSE;
+  }
+ /* makes sure number of bits sits within boundaries */
+ if (pCfg->nbBits < MIN_BITS_SERIALIZED || pCfg->nbBits > MAX_BITS_SERIALIZED)
+  {
+   return FALSE;
+  }
+ pSM->bInProgress = FALSE;
+ /* error only reset automatically here */
+ init_Fifo(&pSM->f);
+ pSM->errors = 0;
+ pSM->bMultidrop = FALSE;
+ pSM->state = swURIdle;
+ pReceiveStruct->frames = NULL;
+ pReceiveStruct->pCfg = pCfg;
+ return TRUE;
+}
+
+boolean swUartReceiveInit(byte swUartRxId, const swUartConfigurationT* pCfg, byte timerId, swUartHwGetRxFct rxFct)
+{
+ swUartRxChannelT* pReceiveStruct = &_receiveSArray[swUartRxId];
+ swUartRxStateMachineT* pSM = &pReceiveStruct->sm;
+ if (swUartRxId >= QTY_OF_RECEIVERS || pCfg == NULL || rxFct == NULL)
+  {
+   return FALSE;
+  }
+ if (time_Receiver(pReceiveStruct, pCfg) == FALSE || init_Receiver(pReceiveStruct, pCfg) == FALSE)
+  {
+   return FALSE;
+  }
+ pSM->c.timerId = timerId;
+ pSM->rxFct = rxFct;
+ gtimerFreeze(timerId);
+ /* installs callback with transmit data array reference as an immutable parameter */
+ gtimerSetRearmCallback(timerId, swUartReceiveCallBack, (long)_receiveSArray + swUartRxId);
+ return TRUE;
+}
+
+/* starts the measure of the bit width of a receiver over */
+static void restart_Autobaud(swUartRxChannelT* pReceiveStruct)
+{
+ pReceiveStruct->autobaudStep = swUABShortest;
+ pReceiveStruct->shortest = 0xffff;
+ pReceiveStruct->edgesToGo = pReceiveStruct->nbOfEdges;
+}
+
+/* takes the run of the line ended by an edge into account: the shortest of a first pass of edges is about a bit,
+   the mean of the runs of a second pass as long as this one, give or take half of it and a tick of sampling, is the
+   bit width */
+static void measure_Run(swUartRxChannelT* pReceiveStruct, word run)
+{
+ swUartConfigurationT* pCfg = pReceiveStruct->pAutobaudCfg;
+ const word shortest = pReceiveStruct->shortest;
+ dword bitWidth, fraction;
+
+ switch (pReceiveStruct->autobaudStep)
+  {
+   case swUABFirstEdge:    /* the run before it has no beginning */
+    restart_Autobaud(pReceiveStruct);
+    break;
+   case swUABShortest:
+    if (run < shortest)
+     {
+      pReceiveStruct->shortest = run;
+     }
+    if (--pReceiveStruct->edgesToGo == 0)
+     {
+      pReceiveStruct->autobaudStep = swUABValidate;
+      pReceiveStruct->edgesToGo = pReceiveStruct->nbOfEdges;
+      pReceiveStruct->runTotal = 0;
+      pReceiveStruct->runCount = 0;
+     }
+    break;
+   case swUABValidate:
+    if (run + 1 < shortest - shortest / 4)
+     {
+      restart_Autobaud(pReceiveStruct);    /* a glitch, now or in the first pass */
+      break;
+     }
+    if (run <= shortest + shortest / 2 + 1)    /* one bit */
+     {
+      pReceiveStruct->runTotal += run;
+      pReceiveStruct->runCount++;
+     }
+    if (--pReceiveStruct->edgesToGo == 0)
+     {
+      if (pReceiveStruct->runCount == 0)
+       {
+        restart_Autobaud(pReceiveStruct);
+        break;
+       }
+      /* mean width of a bit, to a 256th of a tick */
+      bitWidth = pReceiveStruct->runTotal / pReceiveStruct->runCount;
+      fraction = ((pReceiveStruct->runTotal % pReceiveStruct->runCount) * 256 + pReceiveStruct->runCount / 2) /
+                 pReceiveStruct->runCount;
+      if (fraction == 256)
+       {
+        bitWidth++;
+        fraction = 0;
+       }
+      if (bitWidth < min_Width(pCfg) || bitWidth > 0xffff)
+       {
+        restart_Autobaud(pReceiveStruct);
+        break;
+       }
+      pCfg->bitWidth = (word)bitWidth;
+      pCfg->bitWidthFraction = (byte)fraction;
+      pReceiveStruct->autobaudStep = swUABIdle;
+     }
+    break;
+   default:
+    break;
+  }
+}
+
+/* samples the line of a receiver in autobaud mode on every tick to measure its runs between edges: once the bit
+   width is known, and the line has been idle for a character, reception goes on as usual */
+static dword swUartAutobaudCallBack(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ swUartRxChannelT* pReceiveStruct = (swUartRxChannelT*)value;
+ swUartRxStateMachineT* pSM = &pReceiveStruct->sm;
+ const swUartConfigurationT* pCfg = pReceiveStruct->pCfg;
+ swUartDataStateE lineLevel = pSM->rxFct();
+ word run = pReceiveStruct->run;
+ dword idle;
+
+ if (lineLevel != pSM->lastSample)    /* edge */
+  {
+   pReceiveStruct->run = 1;
+   pSM->lastSample = lineLevel;
+   measure_Run(pReceiveStruct, run);
+   return 1;
+  }
+ if (run < 0xffff)
+  {
+   pReceiveStruct->run = ++run;
+  }
+ if (pReceiveStruct->autobaudStep != swUABIdle || lineLevel != swUMark_High)
+  {
+   return 1;
+  }
+ idle = (dword)FRAME_BITS(pCfg) * pCfg->bitWidth;
+ if (run < (idle < 0xffff ? idle : 0xffff))
+  {
+   return 1;
+  }
+ if (time_Receiver(pReceiveStruct, pCfg) == FALSE)    /* should not happen */
+  {
+   restart_Autobaud(pReceiveStruct);
+   return 1;
+  }
+ pSM->state = swURIdle;
+ pSM->bInProgress = FALSE;    /* start bits are looked for from now on */
+ gtimerSetRearmCallback(pSM->c.timerId, swUartReceiveCallBack, value);
+ return GTIMER_CALLBACK_STOP;
+}
+
+boolean swUartReceiveAutobaud(byte swUartRxId, swUartConfigurationT* pCfg, byte timerId, swUartHwGetRxFct rxFct,
+                              byte nbOfEdges)
+{
+ swUartRxChannelT* pReceiveStruct = &_receiveSArray[swUartRxId];
+ swUartRxStateMachineT* pSM = &pReceiveStruct->sm;
+ if (swUartRxId >= QTY_OF_RECEIVERS || pCfg == NULL || rxFct == NULL || nbOfEdges < 2 || min_Width(pCfg) == 0)
+  {
+   return FALSE;
+  }
+ if (init_Receiver(pReceiveStruct, pCfg) == FALSE)
+  {
+   return FALSE;
+  }
+ pCfg->bitWidth = 0;
+ pCfg->bitWidthFraction = 0;
+ pReceiveStruct->pAutobaudCfg = pCfg;
+ pSM->bInProgress = TRUE;    /* keeps swUartReceiveScanForStart from starting anything */
+ pSM->c.timerId = timerId;
+ pSM->rxFct = rxFct;
+ pSM->lastSample = rxFct();
+ pReceiveStruct->run = 0;
+ pReceiveStruct->nbOfEdges = nbOfEdges;
+ pReceiveStruct->autobaudStep = swUABFirstEdge;
+ gtimerFreeze(timerId);
+ gtimerSetRearmCallback(timerId, swUartAutobaudCallBack, (long)pReceiveStruct);
+ gtimerInitAndStart(timerId, 2, FALSE);
+ return TRUE;
+}
+
+boolean swUartReceiveScanForStart(byte swUartRxId)
+{
+ swUartRxChannelT* pReceiveStruct = &_receiveSArray[swUartRxId];
+ swUartRxStateMachineT* pSM = &pReceiveStruct->sm;
+ if (swUartRxId >= QTY_OF_RECEIVERS)
+  {
+   return FALSE;
+  }
+ if (pSM->bInProgress == FALSE && pSM->rxFct() == swUSpace_Low) /* detected a space on the line: Low (0) */
+  {
+   pSM->bInProgress = TRUE;
+   pSM->state = swURStart;
+   TRACE_STATE(traceSwUartRxState, swUartRxId, pSM);
+   pSM->c.carry = 0;
+   if (pReceiveStruct->samplesPerBit != 0)
+    {
+     pSM->scanValues = 0;   /* will store different samples scanned */
+     pSM->scanPosition = 0;   /* will count them: edge of the start bit is sample 0 */
+     pSM->lastSample = swUSpace_Low;
+    }
+   /* sets timer to scan next center bit or to take next sample in case of noise cancellation
+      this will start the reception state machine */
+   gtimerInitAndStart(pSM->c.timerId,
+                      next_Delay(&pSM->c.carry, pReceiveStruct->samplesPerBit != 0 ? pReceiveStruct->sampleStep :
+                                                BIT_STEP(pReceiveStruct->pCfg) >> 1),
+                      FALSE);
+   return TRUE;       /* reports a reception under progress */
+  }
+ return FALSE;
+}
+
+/* number of characters in the FIFO of a receiver, on the reader side as the functions below */
+static dword count_Chars(const swUartRxFifoT* pFifo)
+{
+ return LOAD_ACQUIRE(&pFifo->rxFifoWriteIndex) - pFifo->rxFifoReadIndex;    /* free running indices */
+}
+
+/* nth character of the FIFO of a receiver, 0xffff if there are not as many */
+static word peek_Char(const swUartRxFifoT* pFifo, word nth)
+{
+ if (nth < count_Chars(pFifo))
+  {
+   return (word)pFifo->rxFifo[(pFifo->rxFifoReadIndex + nth) & pFifo->rxFifoSizeMask];
+  }
+ return 0xffff;
+}
+
+/* pulls a character from the FIFO of a receiver, 0xffff if it is empty */
+static word get_Char(swUartRxFifoT* pFifo, UNUSED_FCT_P word unit)
+{
+ dword readIndex = pFifo->rxFifoReadIndex;
+ word ch;
+
+ if (LOAD_ACQUIRE(&pFifo->rxFifoWriteIndex) == readIndex)
+  {
+   return 0xffff;
+  }
+ ch = (word)pFifo->rxFifo[readIndex & pFifo->rxFifoSizeMask];
+ STORE_RELEASE(&pFifo->rxFifoReadIndex, readIndex + 1);    /* gives its room back to the receiver */
+ TRACE(traceSwUartFifoPop, unit, ch);
+ return ch;
+}
+
+/* pulls up to max characters from the FIFO of a receiver, in two runs at most: up to the end of its storage, then
+   from its start */
+static dword read_Chars(swUartRxFifoT* pFifo, RCPT_FIFO_TYPE* dst, dword max, UNUSED_FCT_P word unit)
+{
+ dword readIndex = pFifo->rxFifoReadIndex;
+ dword n = count_Chars(pFifo);
+ dword start = readIndex & pFifo->rxFifoSizeMask;
+ dword run = (dword)pFifo->rxFifoSizeMask + 1 - start;    /* characters before storage wraps */
+
+ if (n > max)
+  {
+   n = max;
+  }
+ if (n == 0)
+  {
+   return 0;
+  }
+ if (run > n)
+  {
+   run = n;
+  }
+ memcpy(dst, &pFifo->rxFifo[start], run * sizeof(*dst));
+ if (n > run)
+  {
+   memcpy(dst + run, pFifo->rxFifo, (n - run) * sizeof(*dst));
+  }
+ STORE_RELEASE(&pFifo->rxFifoReadIndex, readIndex + n);
+ TRACE(traceSwUartFifoRead, unit, n);
+ return n;
+}
+
+static void flush_Chars(swUartRxFifoT* pFifo, UNUSED_FCT_P word unit)
+{
+ STORE_RELEASE(&pFifo->rxFifoReadIndex, LOAD_ACQUIRE(&pFifo->rxFifoWriteIndex));
+ TRACE(traceSwUartFifoFlush, unit, 0);
+}
+
+static byte get_AndClearError(swUartRxFifoT* pFifo, boolean bClearError)
+{
+ if (bClearError)
+  {
+   return TAKE_ERROR(&pFifo->error);
+  }
+ return pFifo->error;
+}
+
+word swUartPeekChar(byte swUartRxId)
+{
+ if (swUartRxId >= QTY_OF_RECEIVERS)
+  {
+   return 0xffff;
+  }
+ return peek_Char(&_receiveSArray[swUartRxId].sm.f, 0);
+}
+
+word swUartGetChar(byte swUartRxId)
+{
+ if (swUartRxId >= QTY_OF_RECEIVERS)
+  {
+   return 0xffff;
+  }
+ return get_Char(&_receiveSArray[swUartRxId].sm.f, swUartRxId);
+}
+
+dword swUartHowManyChars(byte swUartRxId)
+{
+ if (swUartRxId >= QTY_OF_RECEIVERS)
+  {
+   return 0;
+  }
+ return count_Chars(&_receiveSArray[swUartRxId].sm.f);
+}
+
+word swUartPeekNChar(byte swUartRxId, word nth)
+{
+ if (swUartRxId >= QTY_OF_RECEIVERS)
+  {
+   return 0xffff;
+  }
+ return peek_Char(&_receiveSArray[swUartRxId].sm.f, nth);
+}
+
+dword swUartReadBuffer(byte swUartRxId, RCPT_FIFO_TYPE* dst, dword max)
+{
+ if (swUartRxId >= QTY_OF_RECEIVERS || dst == NULL)
+  {
+   return 0;
+  }
+ return read_Chars(&_receiveSArray[swUartRxId].sm.f, dst, max, swUartRxId);
+}
+
+boolean swUartReceiveSetFifo(byte swUartRxId, RCPT_FIFO_TYPE* storage, dword size)
+{
+ if (swUartRxId >= QTY_OF_RECEIVERS)
+  {
+   return FALSE;
+  }
+ return set_Fifo(&_receiveSArray[swUartRxId].sm.f, storage, size);
+}
+
+void swUartFlushChars(byte swUartRxId)
+{
+ if (swUartRxId < QTY_OF_RECEIVERS)
+  {
+   flush_Chars(&_receiveSArray[swUartRxId].sm.f, swUartRxId);
+  }
+}
+
+byte swUartReceiveGetAndClearError(byte swUartRxId, boolean bClearError)
+{
+ if (swUartRxId >= QTY_OF_RECEIVERS)
+  {
+   return 0;
+  }
+ return get_AndClearError(&_receiveSArray[swUartRxId].sm.f, bClearError);
+}
+
+boolean swUartReceiveSetAddress(byte swUartRxId, boolean bMultidrop, word address, word mask)
+{
+ if (swUartRxId >= QTY_OF_RECEIVERS)
+  {
+   return FALSE;
+  }
+ return set_Address(&_receiveSArray[swUartRxId].sm, _receiveSArray[swUartRxId].pCfg, bMultidrop, address, mask);
+}
+
+boolean swUartReceiveSetFrames(byte swUartRxId, swUartFrameT* storage, dword size, byte idleTenths)
+{
+ swUartRxChannelT* pReceiveStruct = &_receiveSArray[swUartRxId];
+ if (swUartRxId >= QTY_OF_RECEIVERS)
+  {
+   return FALSE;
+  }
+ if (storage != NULL && (size == 0 || size > SWUART_MAX_FIFO_SIZE || (size & (size - 1)) != 0 || idleTenths == 0))
+  {
+   return FALSE;
+  }
+ SWUART_ENTER_CRITICAL();    /* the receiver may be closing a frame */
+ pReceiveStruct->frames = storage;
+ pReceiveStruct->framesSizeMask = (word)(size - 1);
+ pReceiveStruct->frameReadIndex = pReceiveStruct->frameWriteIndex = 0;
+ pReceiveStruct->frameFirst = pReceiveStruct->sm.f.rxFifoWriteIndex;
+ pReceiveStruct->frameErrors = 0;
+ pReceiveStruct->idleTenths = idleTenths;
+ SWUART_EXIT_CRITICAL();
+ return TRUE;
+}
+
+dword swUartHowManyFrames(byte swUartRxId)
+{
+ swUartRxChannelT* pReceiveStruct = &_receiveSArray[swUartRxId];
+ if (swUartRxId >= QTY_OF_RECEIVERS || pReceiveStruct->frames == NULL)
+  {
+   return 0;
+  }
+ return LOAD_ACQUIRE(&pReceiveStruct->frameWriteIndex) - pReceiveStruct->frameReadIndex;
+}
+
+boolean swUartGetFrame(byte swUartRxId, swUartFrameT* pFrame)
+{
+ swUartRxChannelT* pReceiveStruct = &_receiveSArray[swUartRxId];
+ dword readIndex;
+ if (swUartRxId >= QTY_OF_RECEIVERS || pReceiveStruct->frames == NULL || pFrame == NULL)
+  {
+   return FALSE;
+  }
+ readIndex = pReceiveStruct->frameReadIndex;
+ if (LOAD_ACQUIRE(&pReceiveStruct->frameWriteIndex) == readIndex)
+  {
+   return FALSE;
+  }
+ *pFrame = pReceiveStruct->frames[readIndex & pReceiveStruct->framesSizeMask];
+ STORE_RELEASE(&pReceiveStruct->frameReadIndex, readIndex + 1);    /* gives its room back to the receiver */
+ return TRUE;
+}
+
+/************************************************************
+ * group section
+ ************************************************************/
+
+/* one tick of the timer of a group: one pass on all its channels */
+static dword swUartGroupCallBack(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ swUartGroupT* This = (swUartGroupT*)value;
+ swUartTxChannelT* pTx = This->txChannels;
+ swUartRxChannelT* pRx = This->rxChannels;
+ word i;
+ byte level;
+
+ for (i = 0; i < This->nbOfTx; i++, pTx++)
+  {
+   if (pTx->sm.bInProgress && --pTx->countdown == 0)
+    {
+     pTx->countdown = SWUART_GROUP_SAMPLES_PER_BIT;
+     level = send_Bit(&pTx->sm);
+     if (level == CHAR_SENT && pull_Char(pTx))
+      {
+       level = send_Bit(&pTx->sm);
+      }
+     TRACE_TX(i, level);
+     if (level != CHAR_SENT)
+      {
+       This->txFct(i, (swUartDataStateE)level);
+      }
+    }
+  }
+ for (i = 0; i < This->nbOfRx; i++, pRx++)
+  {
+   if (pRx->sm.bInProgress)
+    {
+     if (--pRx->countdown == 0)
+      {
+       pRx->countdown = SWUART_GROUP_SAMPLES_PER_BIT;
+       receive_Level(&pRx->sm, pRx->pCfg, This->rxFct(i), i);
+      }
+    }
+   else if (pRx->pCfg != NULL && This->rxFct(i) == swUSpace_Low)  /* start bit began since last tick */
+    {
+     pRx->sm.bInProgress = TRUE;
+     pRx->sm.state = swURStart;
+     pRx->countdown = SWUART_GROUP_SAMPLES_PER_BIT / 2;   /* middle of start bit */
+     TRACE_STATE(traceSwUartRxState, i, &pRx->sm);
+    }
+  }
+ return (dword)(This->bitWidth / SWUART_GROUP_SAMPLES_PER_BIT);
+}
+
+boolean swUartGroupCtor(swUartGroupT* This, word bitWidth, byte timerId,
+                        swUartTxChannelT* txChannels, word nbOfTx, swUartGroupSetTxFct txFct,
+                        swUartRxChannelT* rxChannels, word nbOfRx, swUartGroupGetRxFct rxFct)
+{
+ word i;
+ if (This == NULL || (nbOfTx > 0 && (txChannels == NULL || txFct == NULL)) ||
+     (nbOfRx > 0 && (rxChannels == NULL || rxFct == NULL)))
+  {
+   return FALSE;
+  }
+ if (bitWidth % SWUART_GROUP_SAMPLES_PER_BIT != 0 || bitWidth < 2 * SWUART_GROUP_SAMPLES_PER_BIT)
+  {
+   return FALSE;       /* cannot handle less than 2 gTimer ticks between samples */
+  }
+ for (i = 0; i < nbOfTx; i++)
+  {
+   txChannels[i].pCfg = NULL;
+   txChannels[i].sm.bInProgress = FALSE;
+  }
+ for (i = 0; i < nbOfRx; i++)
+  {
+   rxChannels[i].pCfg = NULL;
+   rxChannels[i].sm.bInProgress = FALSE;
+  }
+ This->txChannels = txChannels;
+ This->rxChannels = rxChannels;
+ This->nbOfTx = nbOfTx;
+ This->nbOfRx = nbOfRx;
+ This->txFct = txFct;
+ This->rxFct = rxFct;
+ This->bitWidth = bitWidth;
+ This->timerId = timerId;
+ gtimerFreeze(timerId);
+ gtimerSetRearmCallback(timerId, swUartGroupCallBack, (long)This);
+ gtimerInitAndStart(timerId, (dword)(bitWidth / SWUART_GROUP_SAMPLES_PER_BIT), FALSE);
+ return TRUE;
+}
+
+boolean swUartGroupSendInit(swUartGroupT* This, word txId, const swUartConfigurationT* pCfg)
+{
+ if (txId >= This->nbOfTx || pCfg == NULL || pCfg->bitWidth != This->bitWidth || pCfg->bitWidthFraction != 0)
+  {
+   return FALSE;
+  }
+ This->txChannels[txId].pCfg = NULL;    /* out of the loop while being set */
+ if (init_Sender(&This->txChannels[txId], pCfg) == FALSE)
+  {
+   return FALSE;
+  }
+ This->txFct(txId, swUMark_High);    /* sets line in mark, idle state */
+ return TRUE;
+}
+
+boolean swUartGroupSendChar(swUartGroupT* This, word txId, word ch)
+{
+ swUartTxChannelT* pTx;
+ if (txId >= This->nbOfTx)
+  {
+   return FALSE;
+  }
+ pTx = &This->txChannels[txId];
+ if (pTx->sm.bInProgress)
+  {
+   return FALSE;    /* countdown of the bit on the line left alone */
+  }
+ pTx->countdown = 1;    /* start bit on next tick: set before start_Char publishes bInProgress */
+ return start_Char(pTx, ch);
+}
+
+boolean swUartGroupSendBlock(swUartGroupT* This, word txId, swUartTxBlockT* pBlock)
+{
+ if (txId >= This->nbOfTx || This->txChannels[txId].pCfg == NULL || pBlock == NULL)
+  {
+   return FALSE;
+  }
+ queue_Block(&This->txChannels[txId], pBlock);
+ return TRUE;
+}
+
+boolean swUartGroupSendIsBusy(swUartGroupT* This, word txId)
+{
+ if (txId >= This->nbOfTx)
+  {
+   return TRUE;
+  }
+ return This->txChannels[txId].sm.bInProgress;
+}
+
+boolean swUartGroupReceiveInit(swUartGroupT* This, word rxId, const swUartConfigurationT* pCfg)
+{
+ if (rxId >= This->nbOfRx || pCfg == NULL || pCfg->bitWidth != This->bitWidth || pCfg->bitWidthFraction != 0 ||
+     pCfg->bTripleScan || pCfg->oversampling != 0)
+  {
+   return FALSE;
+  }
+ This->rxChannels[rxId].pCfg = NULL;    /* out of the loop while being set */
+ return init_Receiver(&This->rxChannels[rxId], pCfg);
+}
+
+boolean swUartGroupReceiveSetAddress(swUartGroupT* This, word rxId, boolean bMultidrop, word address, word mask)
+{
+ if (rxId >= This->nbOfRx)
+  {
+   return FALSE;
+  }
+ return set_Address(&This->rxChannels[rxId].sm, This->rxChannels[rxId].pCfg, bMultidrop, address, mask);
+}
+
+word swUartGroupPeekChar(swUartGroupT* This, word rxId)
+{
+ if (rxId >= This->nbOfRx)
+  {
+   return 0xffff;
+  }
+ return peek_Char(&This->rxChannels[rxId].sm.f, 0);
+}
+
+word swUartGroupPeekNChar(swUartGroupT* This, word rxId, word nth)
+{
+ if (rxId >= This->nbOfRx)
+  {
+   return 0xffff;
+  }
+ return peek_Char(&This->rxChannels[rxId].sm.f, nth);
+}
+
+dword swUartGroupHowManyChars(swUartGroupT* This, word rxId)
+{
+ if (rxId >= This->nbOfRx)
+  {
+   return 0;
+  }
+ return count_Chars(&This->rxChannels[rxId].sm.f);
+}
+
+void swUartGroupFlushChars(swUartGroupT* This, word rxId)
+{
+ if (rxId < This->nbOfRx)
+  {
+   flush_Chars(&This->rxChannels[rxId].sm.f, rxId);
+  }
+}
+
+word swUartGroupGetChar(swUartGroupT* This, word rxId)
+{
+ if (rxId >= This->nbOfRx)
+  {
+   return 0xffff;
+  }
+ return get_Char(&This->rxChannels[rxId].sm.f, rxId);
+}
+
+dword swUartGroupReadBuffer(swUartGroupT* This, word rxId, RCPT_FIFO_TYPE* dst, dword max)
+{
+ if (rxId >= This->nbOfRx || dst == NULL)
+  {
+   return 0;
+  }
+ return read_Chars(&This->rxChannels[rxId].sm.f, dst, max, rxId);
+}
+
+boolean swUartGroupReceiveSetFifo(swUartGroupT* This, word rxId, RCPT_FIFO_TYPE* storage, dword size)
+{
+ if (rxId >= This->nbOfRx)
+  {
+   return FALSE;
+  }
+ return set_Fifo(&This->rxChannels[rxId].sm.f, storage, size);
+}
+
+byte swUartGroupReceiveGetAndClearError(swUartGroupT* This, word rxId, boolean bClearError)
+{
+ if (rxId >= This->nbOfRx)
+  {
+   return 0;
+  }
+ return get_AndClearError(&This->rxChannels[rxId].sm.f, bClearError);
+}
+
+/************************************************************
+ * bit-sliced reception section
+ ************************************************************/
+
+/* lowest line of a non zero mask */
+static byte lowest_Line(swUartSliceMaskT mask)
+{
+#ifdef __GNUC__
+ return (byte)__builtin_ctzl(mask);
+#else
+ byte line = 0;
+ while ((mask & 1) == 0)
+  {
+   mask >>= 1;
+   line++;
+  }
+ return line;
+#endif
+}
+
+/* lines of a bit-sliced receiver which took value samples of their character */
+static swUartSliceMaskT count_Equals(const swUartSliceT* This, byte value)
+{
+ swUartSliceMaskT mask = This->busy;
+ byte j;
+ for (j = 0; j < 4; j++)
+  {
+   mask &= (value >> j & 1) ? This->count[j] : ~This->count[j];
+  }
+ return mask;
+}
+
+/* ORs an error in the lines of a mask */
+static void set_SliceError(swUartSliceT* This, swUartSliceMaskT mask, byte error)
+{
+ byte line;
+ while (mask != 0)
+  {
+   line = lowest_Line(mask);
+   mask &= mask - 1;
+   SET_ERROR(&This->lines[line].error, 1 << error);
+   TRACE(traceSwUartError, line, 1 << error);
+  }
+}
+
+/* checks and stores the characters of lines whose last sample was just taken */
+static void end_SliceCharacters(swUartSliceT* This, swUartSliceMaskT done)
+{
+ const swUartConfigurationT* pCfg = This->pCfg;
+ const swUartSliceMaskT* pData = This->frame + 1;    /* after start bit, LSB first */
+ byte stop = 1 + pCfg->nbBits + (pCfg->parity != swUNoParity);
+ swUartSliceMaskT framing = done & ~This->frame[stop];
+ swUartSliceMaskT parity = 0;
+ byte i, line;
+ word ch;
+
+ if (pCfg->stop == swU2Stop)
+  {
+   framing |= done & ~This->frame[stop + 1];
+  }
+ if (pCfg->parity != swUNoParity)
+  {
+   for (i = 0; i <= pCfg->nbBits; i++)   /* data and parity bits: even number of marks with even parity */
+    {
+     parity ^= pData[i];
+    }
+   parity = done & (pCfg->parity == swUEvenParity ? parity : ~parity);
+   set_SliceError(This, parity, swUParityError);
+  }
+ set_SliceError(This, framing, swUFramingError);
+ for (done &= ~(framing | parity); done != 0; done &= done - 1)
+  {
+   line = lowest_Line(done);
+   ch = 0;
+   for (i = 0; i < pCfg->nbBits; i++)
+    {
+     ch |= (word)((pData[i] >> line) & 1) << i;
+    }
+   push_Char(&This->lines[line], ch, line);
+  }
+}
+
+/* one tick of the timer of a bit-sliced receiver */
+static dword swUartSliceCallBack(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ swUartSliceT* This = (swUartSliceT*)value;
+
+ swUartSliceOnSample(This, This->rxFct());
+ return (dword)(This->pCfg->bitWidth / SWUART_GROUP_SAMPLES_PER_BIT);
+}
+
+boolean swUartSliceCtor(swUartSliceT* This, const swUartConfigurationT* pCfg, swUartSliceLineT* lines, byte nbOfLines,
+                        byte timerId, swUartSliceGetRxFct rxFct)
+{
+ byte i;
+ if (This == NULL || pCfg == NULL || lines == NULL || nbOfLines == 0 || nbOfLines > SWUART_SLICE_LINES ||
+     pCfg->bTripleScan || pCfg->oversampling != 0 || pCfg->bitWidthFraction != 0)
+  {
+   return FALSE;
+  }
+ if (pCfg->nbBits < MIN_BITS_SERIALIZED || pCfg->nbBits > MAX_BITS_SERIALIZED)
+  {
+   return FALSE;
+  }
+ if (rxFct != NULL &&
+     (pCfg->bitWidth % SWUART_GROUP_SAMPLES_PER_BIT != 0 || pCfg->bitWidth < 2 * SWUART_GROUP_SAMPLES_PER_BIT))
+  {
+   return FALSE;       /* cannot handle less than 2 gTimer ticks between samples */
+  }
+ for (i = 0; i < nbOfLines; i++)
+  {
+   init_Fifo(&lines[i]);
+  }
+ This->pCfg = pCfg;
+ This->lines = lines;
+ This->rxFct = rxFct;
+ This->enabled = nbOfLines < SWUART_SLICE_LINES ? ((swUartSliceMaskT)1 << nbOfLines) - 1 : ~(swUartSliceMaskT)0;
+ This->busy = 0;
+ for (i = 0; i < SWUART_GROUP_SAMPLES_PER_BIT; i++)
+  {
+   This->phase[i] = 0;
+  }
+ This->frameLength = FRAME_BITS(pCfg);
+ This->tick = 0;
+ if (rxFct != NULL)
+  {
+   gtimerFreeze(timerId);
+   gtimerSetRearmCallback(timerId, swUartSliceCallBack, (long)This);
+   gtimerInitAndStart(timerId, (dword)(pCfg->bitWidth / SWUART_GROUP_SAMPLES_PER_BIT), FALSE);
+  }
+ return TRUE;
+}
+
+void swUartSliceOnSample(swUartSliceT* This, swUartSliceMaskT sample)
+{
+ swUartSliceMaskT active = This->busy & This->phase[This->tick];   /* lines in the middle of a bit */
+ swUartSliceMaskT start = This->enabled & ~This->busy & ~sample;   /* start bit began since last tick */
+ swUartSliceMaskT carry, next, first, done;
+ byte i, last = This->frameLength - 1;
+
+ if (active != 0)
+  {
+   /* sample shifted in the frame of active lines, first sample ending in plane 0 */
+   for (i = 0; i < last; i++)
+    {
+     This->frame[i] = (This->frame[i] & ~active) | (This->frame[i + 1] & active);
+    }
+   This->frame[last] = (This->frame[last] & ~active) | (sample & active);
+   /* count of samples incremented for active lines */
+   for (carry = active, i = 0; i < 4 && carry != 0; i++)
+    {
+     next = This->count[i] & carry;
+     This->count[i] ^= carry;
+     carry = next;
+    }
+   first = active & count_Equals(This, 1) & sample;   /* start bit has to be a space */
+   set_SliceError(This, first, swUFramingError);
+   done = active & count_Equals(This, This->frameLength);
+   if (done != 0)
+    {
+     end_SliceCharacters(This, done);
+    }
+   This->busy &= ~(first | done);
+   This->phase[This->tick] &= ~(first | done);
+  }
+ if (start != 0)
+  {
+   This->busy |= start;
+   This->phase[(This->tick + SWUART_GROUP_SAMPLES_PER_BIT / 2) % SWUART_GROUP_SAMPLES_PER_BIT] |= start;   /* middle of start bit */
+   for (i = 0; i < 4; i++)
+    {
+     This->count[i] &= ~start;
+    }
+  }
+ This->tick = (This->tick + 1) % SWUART_GROUP_SAMPLES_PER_BIT;
+}
+
+dword swUartSliceHowManyChars(swUartSliceT* This, byte line)
+{
+ if (line >= SWUART_SLICE_LINES || (This->enabled >> line & 1) == 0)
+  {
+   return 0;
+  }
+ return count_Chars(&This->lines[line]);
+}
+
+word swUartSliceGetChar(swUartSliceT* This, byte line)
+{
+ if (line >= SWUART_SLICE_LINES || (This->enabled >> line & 1) == 0)
+  {
+   return 0xffff;
+  }
+ return get_Char(&This->lines[line], line);
+}
+
+dword swUartSliceReadBuffer(swUartSliceT* This, byte line, RCPT_FIFO_TYPE* dst, dword max)
+{
+ if (line >= SWUART_SLICE_LINES || (This->enabled >> line & 1) == 0 || dst == NULL)
+  {
+   return 0;
+  }
+ return read_Chars(&This->lines[line], dst, max, line);
+}
+
+boolean swUartSliceSetFifo(swUartSliceT* This, byte line, RCPT_FIFO_TYPE* storage, dword size)
+{
+ if (line >= SWUART_SLICE_LINES || (This->enabled >> line & 1) == 0)
+  {
+   return FALSE;
+  }
+ return set_Fifo(&This->lines[line], storage, size);
+}
+
+void swUartSliceFlushChars(swUartSliceT* This, byte line)
+{
+ if (line < SWUART_SLICE_LINES && (This->enabled >> line & 1) != 0)
+  {
+   flush_Chars(&This->lines[line], line);
+  }
+}
+
+byte swUartSliceGetAndClearError(swUartSliceT* This, byte line, boolean bClearError)
+{
+ if (line >= SWUART_SLICE_LINES || (This->enabled >> line & 1) == 0)
+  {
+   return 0;
+  }
+ return get_AndClearError(&This->lines[line], bClearError);
+}
+
+/************************************************************
+ * edge reception section
+ ************************************************************/
+
+/* errors of the bits of a complete character, start bit first, as receive_Level would find them: parity and stop
+   bits (the start bit is checked on its own) */
+static byte check_Frame(const swUartConfigurationT* pCfg, word frame)
+{
+ byte stop = 1 + pCfg->nbBits;
+ byte errors = 0;
+
+ if (pCfg->parity != swUNoParity)
+  {
+   /* data and parity bits: even number of marks with even parity */
+   if ((odd_Parity(frame >> 1 & ((1 << pCfg->nbBits) - 1)) ^ (frame >> stop & 1)) != (pCfg->parity == swUOddParity))
+    {
+     errors |= 1 << swUParityError;
+    }
+   stop++;
+  }
+ if ((frame >> stop & 1) == 0 || (pCfg->stop == swU2Stop && (frame >> (stop + 1) & 1) == 0))
+  {
+   errors |= 1 << swUFramingError;
+  }
+ return errors;
+}
+
+/* checks the bits of a complete character and stores it */
+static void end_EdgeCharacter(swUartEdgeT* This)
+{
+ byte errors = check_Frame(This->pCfg, This->frame);
+
+ if (errors != 0)
+  {
+   SET_ERROR(&This->f.error, errors);
+   TRACE(traceSwUartError, 0, errors);
+  }
+ else
+  {
+   push_Char(&This->f, This->frame >> 1 & ((1 << This->pCfg->nbBits) - 1), 0);
+  }
+}
+
+/* gives the level of the line to the bits of the character being received whose middle is before a time */
+static void advance_Edge(swUartEdgeT* This, dword time)
+{
+ const dword bitStep = BIT_STEP(This->pCfg);
+ const dword frameEnd = (dword)This->frameLength * (This->pCfg->bitWidth + 1);
+ dword elapsed = time - This->frameStart;
+ dword n;
+
+ if (This->bInFrame == FALSE)
+  {
+   return;
+  }
+ elapsed = (elapsed < frameEnd ? elapsed : frameEnd) << 8;    /* in 256ths of a tick */
+ if (elapsed <= bitStep >> 1)
+  {
+   return;
+  }
+ n = (elapsed - (bitStep >> 1) + bitStep - 1) / bitStep;    /* bits whose middle is before time */
+ if (n > This->frameLength)
+  {
+   n = This->frameLength;
+  }
+ if (n > This->nbOfBits)
+  {
+   if (This->level == swUMark_High)
+    {
+     This->frame |= (word)(((1 << n) - 1) & ~((1 << This->nbOfBits) - 1));
+    }
+   This->nbOfBits = (byte)n;
+  }
+ if (This->frame & 1)    /* start bit back to mark in its middle */
+  {
+   SET_ERROR(&This->f.error, 1 << swUFramingError);
+   TRACE(traceSwUartError, 0, 1 << swUFramingError);
+   This->bInFrame = FALSE;
+  }
+ else if (This->nbOfBits == This->frameLength)
+  {
+   end_EdgeCharacter(This);
+   This->bInFrame = FALSE;
+  }
+}
+
+boolean swUartEdgeCtor(swUartEdgeT* This, const swUartConfigurationT* pCfg)
+{
+ if (This == NULL || pCfg == NULL || pCfg->bTripleScan || pCfg->oversampling != 0 || pCfg->bitWidth < 2)
+  {
+   return FALSE;
+  }
+ if (pCfg->nbBits < MIN_BITS_SERIALIZED || pCfg->nbBits > MAX_BITS_SERIALIZED)
+  {
+   return FALSE;
+  }
+ init_Fifo(&This->f);
+ This->pCfg = pCfg;
+ This->frameLength = FRAME_BITS(pCfg);
+ This->level = swUMark_High;
+ This->bInFrame = FALSE;
+ return TRUE;
+}
+
+void swUartEdgeOnEdge(swUartEdgeT* This, dword time, swUartDataStateE level)
+{
+ advance_Edge(This, time);
+ if (This->bInFrame == FALSE && level == swUSpace_Low && This->level == swUMark_High)    /* start bit */
+  {
+   This->bInFrame = TRUE;
+   This->frameStart = time;
+   This->frame = 0;
+   This->nbOfBits = 0;
+  }
+ This->level = level;
+}
+
+void swUartEdgeOnTime(swUartEdgeT* This, dword now)
+{
+ advance_Edge(This, now + 1);    /* level known up to now included */
+}
+
+dword swUartEdgeHowManyChars(swUartEdgeT* This)
+{
+ return count_Chars(&This->f);
+}
+
+word swUartEdgeGetChar(swUartEdgeT* This)
+{
+ return get_Char(&This->f, 0);
+}
+
+dword swUartEdgeReadBuffer(swUartEdgeT* This, RCPT_FIFO_TYPE* dst, dword max)
+{
+ if (dst == NULL)
+  {
+   return 0;
+  }
+ return read_Chars(&This->f, dst, max, 0);
+}
+
+void swUartEdgeFlushChars(swUartEdgeT* This)
+{
+ flush_Chars(&This->f, 0);
+}
+
+byte swUartEdgeGetAndClearError(swUartEdgeT* This, boolean bClearError)
+{
+ return get_AndClearError(&This->f, bClearError);
+}
+
+/************************************************************
+ * capture decoding section
+ ************************************************************/
+
+/* samples scanned at once for start bits */
+#define CAPTURE_WORD_SAMPLES (8 * sizeof(dword))
+
+/* level of one sample of a capture: 1 for mark */
+static byte capture_Sample(const swUartCaptureT* pCapture, dword i)
+{
+ if (pCapture->bitsPerSample == 1)
+  {
+   return pCapture->samples[i >> 3] >> (i & 7) & 1;
+  }
+ return pCapture->samples[i] >> pCapture->channel & 1;
+}
+
+/* levels of CAPTURE_WORD_SAMPLES samples from i on, first one in bit 0: the capture should go on 8 samples
+   further */
+static dword capture_Word(const swUartCaptureT* pCapture, dword i)
+{
+ const byte* p;
+ dword w = 0, x;
+ byte k;
+
+ if (pCapture->bitsPerSample == 1)
+  {
+   p = pCapture->samples + (i >> 3);
+   for (k = 0; k < sizeof(dword); k++)    /* one load on little-endian targets */
+    {
+     w |= (dword)p[k] << 8 * k;
+    }
+   if (i & 7)
+    {
+     w = w >> (i & 7) | (dword)p[sizeof(dword)] << (CAPTURE_WORD_SAMPLES - (i & 7));
+    }
+   return w;
+  }
+ p = pCapture->samples + i;
+ for (k = 0; k < CAPTURE_WORD_SAMPLES; k += 4, p += 4)
+  {
+   /* bit of the channel in 4 samples, gathered by one product: sample n lands in bit 28 + n */
+   x = ((dword)p[0] | (dword)p[1] << 8 | (dword)p[2] << 16 | (dword)p[3] << 24) >> pCapture->channel & 0x01010101UL;
+   w |= (x * 0x10204080UL >> 28 & 0xf) << k;
+  }
+ return w;
+}
+
+/* first sample from i on at space right after one at mark, or end if none */
+static dword find_Start(const swUartCaptureT* pCapture, dword i, dword end)
+{
+ dword w, falls;
+ dword previous = i > 0 ? capture_Sample(pCapture, i - 1) : 1;    /* mark at the beginning */
+
+ while (end - i >= CAPTURE_WORD_SAMPLES + 8)    /* a whole word of samples at each step */
+  {
+   w = capture_Word(pCapture, i);
+   falls = ~w & (w << 1 | previous);
+   if (falls != 0)
+    {
+     return i + lowest_Line(falls);
+    }
+   previous = w >> (CAPTURE_WORD_SAMPLES - 1);
+   i += CAPTURE_WORD_SAMPLES;
+  }
+ for (; i < end; i++)
+  {
+   w = capture_Sample(pCapture, i);
+   if (w == 0 && previous != 0)
+    {
+     return i;
+    }
+   previous = w;
+  }
+ return end;
+}
+
+dword swUartDecodeCapture(const swUartConfigurationT* pCfg, const swUartCaptureT* pCapture, dword* pPosition,
+                          swUartDecodedCharT* pChars, dword maxChars)
+{
+ word frame;
+ byte frameLength, bit;
+ dword bitStep, i, start, middle, n = 0;
+
+ if (pCfg == NULL || pCapture == NULL || pPosition == NULL || pChars == NULL || pCfg->bitWidth == 0 ||
+     (pCapture->bitsPerSample != 1 && pCapture->bitsPerSample != 8) || pCapture->channel > 7 ||
+     *pPosition > pCapture->nbOfSamples)
+  {
+   return 0;
+  }
+ if (pCfg->nbBits < MIN_BITS_SERIALIZED || pCfg->nbBits > MAX_BITS_SERIALIZED)
+  {
+   return 0;
+  }
+ bitStep = BIT_STEP(pCfg);
+ frameLength = FRAME_BITS(pCfg);
+ i = *pPosition;
+ while (n < maxChars)
+  {
+   start = find_Start(pCapture, i, pCapture->nbOfSamples);
+   if (pCapture->nbOfSamples - start <= ((frameLength - 1) * bitStep + (bitStep >> 1)) >> 8)
+    {
+     i = start;    /* character not complete: next call goes on from its start bit */
+     break;
+    }
+   if (capture_Sample(pCapture, start + (bitStep >> 9)) != 0)
+    {
+     i = start + 1;    /* start bit back to mark in its middle: a glitch */
+     continue;
+    }
+   frame = 0;
+   for (bit = 1, middle = (bitStep >> 1) + bitStep; bit < frameLength; bit++, middle += bitStep)    /* in 256ths */
+    {
+     frame |= (word)capture_Sample(pCapture, start + (middle >> 8)) << bit;
+    }
+   pChars[n].position = start;
+   pChars[n].ch = frame >> 1 & ((1 << pCfg->nbBits) - 1);
+   pChars[n].errors = check_Frame(pCfg, frame);
+   n++;
+   i = start + ((middle - bitStep) >> 8);    /* middle of the last stop bit */
+  }
+ *pPosition = i;
+ return n;
+}
@@ -1,289 +1,858 @@
-#ifndef __SWUART_H_INCLUDED__
-#define __SWUART_H_INCLUDED__
-/**
- * \defgroup swUart generic software UART (Universal Asynchronous Reception Transmission)
- * \{
- * Purpose
- * =======
- * This module, \c swUart, is a working example of an asynchronous reception/transmission (Rx/Tx) implementation
- * completely software driven and associated with another software driven module: \c gTimer, \ref gTimer with
- * provision for callback\n
- * Both modules are generic. They are mainly intended to work in embedded contexts which are _not_ extremely
- * hard time constraint\n
- *
- * Details
- * =======
- * Module \c gTimer run in the main loop\n
- * Software UART's run as state machines which are implemented as \c gTimer callbacks\n
- * This C code is portable (mainly written for and tested under \c GCC) can be tested on a PC box for evaluation
- * and ported on an embedded platform with available access of I/O line and a possibility to hook \c gTimer to a system
- * timer\n
- * Transmit and receive sections are clearly separated (so the optimizer should do its job and
- * eliminate what is not used)\n
- * More than one transmitter and one receiver can coexist: their respective maximum quantities are statically
- * defined by QTY_OF_SENDERS and QTY_OF_RECEIVERS constants which set sizes of internal arrays of management structures
- * in this module\n
- * Each transmitter is defined by:
- * - its configuration \ref swUartConfigurationT,
- * - a dedicated \ref gTimer, and
- * - an I/O function of type \ref swUartHwSetTxFct whose role is to set the transmission line
- *
- * Each receiver is defined by:
- * - its configuration \ref swUartConfigurationT,
- * - a dedicated \ref gTimer, and
- * - an I/O function of type \ref swUartHwGetRxFct whose role is to read the reception line
- *
- * \file swUart.h
- * \brief header of the swUart module
- * \author Gerard Gauthier
- * \date 2015/03
- */
-
-#include "terms.h" /** defines common and intuitive integer types like byte, word, dword, also TRUE, NULL...  */
-
-/** defines parity */
-typedef enum _swUartParityE
-{ swUEvenParity = 2, swUOddParity = 1, swUNoParity = 0 } swUartParityE;
-/** defines number of stop bits */
-typedef enum _swUartStopBitsE
-{ swU1Stop = 1, swU2Stop = 2 } swUartStopBitsE;
-/** \brief defines space and mark line states
- *
- * - space: 0 / LOW  / 0V (TTL) / +5~15V (EIA-232)
- * - mark:  1 / HIGH / 5V (TTL) / -5~15V (EIA-232)
- */
-typedef enum _swUartDataStateE
-{ swUSpace_Low = 0, swUMark_High = 1 } swUartDataStateE;
-
-/** reception errors */
-typedef enum _swUartErrorBitDefinitionE
-{ swUFramingError = 0, swUParityError = 1, swUOverrunError = 2 } swUartErrorBitDefinitionE;
-
-/** I/O function type for setting the Tx line */
-typedef void (*swUartHwSetTxFct)(swUartDataStateE value);
-/** I/O function type for reading the Rx line */
-typedef swUartDataStateE (*swUartHwGetRxFct)(void);
-
-/** \brief swUART configuration structure
- *
- * this structure is to be set to user values and will be passed to initializer that will keep
- * a reference on it
- * \note though theoretically, \p bitWith should be a \c dword, it is declared a word to save some space
- * in this structure and in the module management\n
- * the fact is it has been estimated extremely unlikely to deal with bit rates imposing this value to be
- * above 65,535
- * \warning \p bitWidth has restrictions! See #swUartSendInit and #swUartReceiveInit
- */
-typedef struct _swUartConfigurationT
-{
- word bitWidth; /**< duration of one bit, unit is timer reload value */
- swUartStopBitsE stop; /**< number of stop bits: 1 or 2 */
- swUartParityE parity; /**< type of parity: none, even, or odd */
- byte nbBits; /**< number of bits to serialize: 3 to 10 */
- boolean bTripleScan; /**< if each bit is scanned three times on reception (instead of one time) */
-}swUartConfigurationT;
-
-/************************************************************
- * transmission section
- ************************************************************/
-
-/** \brief initializes a swUART sending state machine
- *
- * this initializer should be called before any call to send function with the same \c swUartTxId
- * \return TRUE if parameters are acceptable (no reference is NULL, \c swUartTxId is within bounds...)
- * \warning \c bitWidth of configuration parameter should be set to 2 at least (restriction in gTimer)
- *
- */
-boolean swUartSendInit(byte swUartTxId /**< swUART Tx index, zero-based */,
-                       const swUartConfigurationT* pConfig /**< reference to configuration parameters */,
-                       byte timerId /**< index of the generic timer that will controls proper delays */,
-                       swUartHwSetTxFct txFct /**< I/O function to set a space or a break position */);
-
-/** \brief sends a character through a state machine of identifier \p swUartTxId
- *
- * \note \p ch is a word because more than 8 bits can be sent if configuration is such
- * \return \c TRUE if \p ch is being serialized, essentially if sending state machine is not busy and correctly initialized
- */
-boolean swUartSendChar(byte swUartTxId /**< swUart Tx index, zero-based */, word ch /**< character to be serialized */);
-
-/** \brief not available for transmit
- *
- * \return \c TRUE if transmission is busy and would not accept sending something
- */
-boolean swUartSendIsBusy(byte swUartTxId /**< swUart Tx index, zero-based */);
-
-/** \brief sends a stream of data
- *
- * sends a stream of data of size \p dataSz \n
- * the caller must provide reference to a word which stores where we are in the sending: \p pIndex \n
- * the value at this reference address must be set to zero
- * \note what \p data references is an array of bytes if field \c nbBits in configuration structure
- * \ref swUartConfigurationT is less than 9 and it is an array of _words_ otherwise
- * \return \c TRUE when send streaming is completed
- */
-boolean swUartSendData(byte swUartTxId /**< swUart Tx index, zero-based */,
-                       const void* data /**< data to send, array of bytes or words depending on \c nbBits */,
-                       word dataSz /**< number of data items to send */,
-                       word* pIndex /**< reference to where we are in the sending */);
-
-/************************************************************
- * reception section
- ************************************************************/
-
-/** \brief initializes a swUART receiving state machine and logics
- *
- * this initializer should be called before any call to receive function with the same \p swUartRxId
- * \return TRUE if parameters are acceptable (no reference is NULL, \p swUartRxId is within bounds...)
- * \warning configuration parameter \c bitWidth has restrictions:
- * - should be a multiple of _4_ if configuration parameter \c bTripleScan is \c FALSE
- * - should be a multiple of _8_ if configuration parameter \c bTripleScan is \c TRUE
- */
-boolean swUartReceiveInit(byte swUartRxId /**< swUART Rx index, zero-based */,
-                          const swUartConfigurationT* pCfg /**< reference to configuration parameters */,
-                          byte timerId /**< index of the generic timer that will controls proper delays */,
-                          swUartHwGetRxFct rxFct /**< I/O function to sense a space or a break position */);
-
-/** \brief test the reception line and engage the reception state machine when start condition sensed
- *
- * this function has to be called as often as possible to test whether a start condition on the reception line has occurred\n
- * if a start condition has occurred the reception state machine is primed\n
- * it can be safely called when a reception is already under way
- * \return \c TRUE iff a start condition has just been sensed
- */
-boolean swUartReceiveScanForStart(byte swUartRxId /**< swUart Tx index, zero-based */);
-
-/** \brief returns the least recently received character leaving the FIFO unaffected
- *
- * can be used to test if some character is ready to be read
- * \return most recent character or 0xffff if reception FIFO is empty (or if an error occurred)
- */
-word swUartPeekChar(byte swUartRxId /**< swUART Rx index, zero-based */);
-
-/** \brief returns the nth received character leaving the FIFO unaffected
- *
- * least recently received character is of rank zero
- * \return the targeted character or 0xffff if reception FIFO is empty (or if an error occurred)
- */
-word swUartPeekNChar(byte swUartRxId /**< swUART Rx index, zero-based */, byte nth /**< zero-based rank of character */);
-
-/** \brief number of characters available in the reception FIFO
- *
- * \return this number - zero returned not only when FIFO is empty but also in case of error
- */
-byte swUartHowManyChars(byte swUartRxId /**< swUART Rx index, zero-based */);
-
-/** \brief empties the reception FIFO
- */
-void swUartFlushChars(byte swUartRxId /**< swUART Rx index, zero-based */);
-
-/** \brief pulls available character from the reception FIFO
- *
- * this character is the least recently received
- * \return this character and 0xffff in case of error or if FIFO is empty
- */
-word swUartGetChar(byte swUartRxId /**< swUART Rx index, zero-based */);
-
-/** \brief return the error value and possibly clear it
- *
- * the error is a bit-field with bit set according to definitions stated in \b swUartErrorBitDefinitionE
- * \return value of the error before it is possibly cleared
- */
-boolean swUartReceiveGetAndClearError(byte swUartRxId /**< swUart Tx index, zero-based */,
-                                      boolean bClearError /**< \c TRUE, should the error be cleared */);
-
-/************************************************************
- * some more details for doxygen
- ************************************************************/
-
-/**
- * \}
- * \addtogroup swUart
- * How to
- * ======
- * In order to illustrate a typical use of this module for both transmission and reception,
- * some code snippets for one UART are presented here\n
- * First implement <tt>void setTxOutput(swUartDataStateE s)</tt> and <tt>swUartDataStateE getRxInput(void)</tt> to
- * inform the module how to handle transmission and reception actual signals. E.g.
- * \code
-void setTxOutput(swUartDataStateE s)
- {
-  _setIo(XX, s==swUSpace_Low?0:1);
- }
-swUartDataStateE getRxInput(void)
- {
-  return(_getIo(XY)==0?swUSpace_Low:swUMark_High);
- }
- * \endcode
- * Then initialize soft timer manager, dedicate two timers for Tx and Rx, and initialize TX and Rx with
- * a configuration structure. Timer ID's have to be defined in header file: \c system.h
- * \code
-const byte uartIdx=0;
-swUartConfigurationT swUartCfg={
-     nbBits:8, parity:swUEvenParity, stop:swU2Stop, bitWidth:4, bTripleScan:FALSE};
-gtimerInitModule();
-gtimerReserve(SWUART1_TX_TIMER_ID);
-gtimerReserve(SWUART1_RX_TIMER_ID);
-swUartSendInit(uartIdx, &swUartCfg, SWUART1_TX_TIMER_ID, setTxOutput);
-swUartReceiveInit(uartIdx, &swUartCfg, SWUART1_RX_TIMER_ID, getRxInput);
- * \endcode
- * Follows a test example implemented in the \c main loop. This example constantly send the same string over and over again
- * and tries to catch what is sent to display it. Two strategies to used to read the incoming stream:
- * - #swUartGetChar to pull characters one by one from the FIFO
- * - have a look into the FIFO with #swUartHowManyChars, #swUartPeekNChar, and flush it with #swUartFlushChars
- *
- * Call to #swUartReceiveScanForStart is necessary to start the Rx state machine which is managed by the timer\n
- * It is interesting noting this example directly or indirectly calls almost all the methods of this module
- * \code
-while(1)
-{
-   static word index=0;
-   static char* pCh="Hello world!\n"; // be careful: RCPT_FIFO_SIZE_IN_BITS should be 4 or more in swUart module
-   static boolean bUsePeek=FALSE; // flag to alternate use of PeekN and GetChar to read received chars
-   byte n, p;
-   word ch;
-
-    if(bTimerInterruptFired) // flag coming from timer interrupt
-     gtimerOnTick(); // manages gTimer
-    // send text gradually until returns TRUE, indicating all is done
-    if(swUartSendData(uartIdx, pCh, strlen(pCh), &index))
-     index=0; // sends over and over again
-    swUartReceiveScanForStart(0); // scans start condition which will start Rx stat machine
-    if(swUartReceiveGetAndClearError(uartIdx, FALSE)) // scan errors
-    {
-      // this one will read errors and clear them
-      printf("Errors!!! Value: %i\n", (int)swUartReceiveGetAndClearError(uartIdx, TRUE));
-    }
-    if(bUsePeek) // will read inbound characters through 'peek' mechanism
-    {
-     // will peek last received until we got an LF
-     n=swUartHowManyChars(uartIdx);
-     if(n>0)
-     {
-      if(swUartPeekNChar(uartIdx, n-1)=='\n')
-      {
-       // we got the LF: get string through peekNChar function and flush
-       for(p=0; p<n; p++)
-       {
-        ch=swUartPeekNChar(uartIdx, p);
-        printf("Peeked: '%c' - 0x%03x\n", _printable(ch), ch); // _printable returns space if ch is not 'nice'
-       }
-       swUartFlushChars(uartIdx);
-       bUsePeek=FALSE; // switch to getChar method for next string to fetch
-      }
-     }
-    }
-    else
-    {
-     ch=swUartGetChar(uartIdx);
-     if(ch!=0xffff) // char is valid
-     {
-      printf("Received: '%c' - 0x%03x\n", _printable(ch), ch);
-      if(ch=='\n') // got entire string: switch to peek method
-       bUsePeek=TRUE;
-     }
-    }
-}
- * \endcode
- */
-
-#endif // __SWUART_H_INCLUDED__
+#ifndef __SWUART_H_INCLUDED__
+#define __SWUART_H_INCLUDED__
+/**
+ * \defgroup swUart generic software UART (Universal Asynchronous Reception Transmission)
+ * \{
+ * Purpose
+ * =======
+ * This module, \c swUart, is a working example of an asynchronous reception/transmission (Rx/Tx) implementation
+ * completely software driven and associated with another software driven module: \c gTimer, \ref gTimer with
+ * provision for callback\n
+ * Both modules are generic. They are mainly intended to work in embedded contexts which are _not_ extremely
+ * hard time constraint\n
+ *
+ * Details
+ * =======
+ * Module \c gTimer run in the main loop\n
+ * Software UART's run as state machines which are implemented as \c gTimer callbacks\n
+ * This C code is portable (mainly written for and tested under \c GCC) can be tested on a PC box for evaluation
+ * and ported on an embedded platform with available access of I/O line and a possibility to hook \c gTimer to a system
+ * timer\n
+ * Transmit and receive sections are clearly separated (so the optimizer should do its job and
+ * eliminate what is not used)\n
+ * More than one transmitter and one receiver can coexist. With the functions which take an index (\c swUartTxId,
+ * \c swUartRxId), their respective maximum quantities are statically defined by QTY_OF_SENDERS and QTY_OF_RECEIVERS
+ * constants which set sizes of internal arrays of management structures in this module. Groups and bit-sliced
+ * receivers are sized at run time instead, on tables provided by the caller\n
+ * Each transmitter is defined by:
+ * - its configuration \ref swUartConfigurationT,
+ * - a dedicated \ref gTimer, and
+ * - an I/O function of type \ref swUartHwSetTxFct whose role is to set the transmission line
+ *
+ * Each receiver is defined by:
+ * - its configuration \ref swUartConfigurationT,
+ * - a dedicated \ref gTimer, and
+ * - an I/O function of type \ref swUartHwGetRxFct whose role is to read the reception line
+ *
+ * Many channels are better run in groups (\ref swUartGroupT): all the transmitters and receivers of a group share
+ * the same \c bitWidth, one single \ref gTimer and one I/O function for each direction, which takes the channel index.
+ * Their tables are provided by the caller, with as many channels as needed, and on each tick of the timer
+ * (\c SWUART_GROUP_SAMPLES_PER_BIT ticks per bit) one tight loop advances all of them. Receivers of a group
+ * look for start bits by themselves on these ticks: #swUartReceiveScanForStart is not needed\n
+ *
+ * Lines which all come on one input port, with the same configuration, are best received by a bit-sliced receiver
+ * (\ref swUartSliceT): one sample of the port per tick, one bit per line, advances all of them at once with bitwise
+ * operations (start detection, sampling, parity and stop checks), so that its cost hardly depends on the number of lines.
+ * Only received characters are handled one by one, to store them in the FIFO of their line\n
+ *
+ * When the times of the edges of a line are known, from a capture interrupt or a recorded list, an edge receiver
+ * (\ref swUartEdgeT) rebuilds characters from the lengths of the runs between edges: no timer, no sampling, its cost
+ * only depends on the number of edges\n
+ * Recorded samples of a line, such as a logic analyzer capture, are decoded offline by #swUartDecodeCapture, which
+ * skips idle lines a word of samples at a time\n
+ *
+ * A receiver can also delimit frames, as protocols like Modbus RTU do, by the silences of its line: after a given idle
+ * time it queues a descriptor of the characters received since the last one (see #swUartReceiveSetFrames), so that
+ * the application handles a whole message at once instead of polling for each character\n
+ *
+ * On a multidrop bus, receivers of 9-bit characters can keep only what is addressed to them: characters whose last data
+ * bit is set carry an address, which selects the receiver or not, and the characters which follow are dropped before
+ * they reach the FIFO unless it is selected (see #swUartReceiveSetAddress)\n
+ *
+ * The reception FIFO of each receiver is lock-free with one producer and one consumer: the receiver may run (in the
+ * callback of its timer) on a real-time thread or core while one reader drains characters on another, without any
+ * lock. Functions reading a FIFO should only be called from this one reader\n
+ *
+ * With \c SWUART_IMPLEMENTS_TRACE defined, the state reached on every bit, characters going through the reception
+ * FIFO and reception errors are recorded in the ring of the \ref trace module, to look into timings after the fact\n
+ *
+ * \file swUart.h
+ * \brief header of the swUart module
+ * \author Gerard Gauthier
+ * \date 2015/03
+ */
+
+#include "terms.h" /** defines common and intuitive integer types like byte, word, dword, also TRUE, NULL...  */
+
+/** defines parity */
+typedef enum _swUartParityE
+{ swUEvenParity = 2, swUOddParity = 1, swUNoParity = 0 } swUartParityE;
+/** defines number of stop bits */
+typedef enum _swUartStopBitsE
+{ swU1Stop = 1, swU2Stop = 2 } swUartStopBitsE;
+/** \brief defines space and mark line states
+ *
+ * - space: 0 / LOW  / 0V (TTL) / +5~15V (EIA-232)
+ * - mark:  1 / HIGH / 5V (TTL) / -5~15V (EIA-232)
+ */
+typedef enum _swUartDataStateE
+{ swUSpace_Low = 0, swUMark_High = 1 } swUartDataStateE;
+
+/** reception errors: on overrun, characters received while the FIFO is full are lost */
+typedef enum _swUartErrorBitDefinitionE
+{ swUFramingError = 0, swUParityError = 1, swUOverrunError = 2 } swUartErrorBitDefinitionE;
+
+/** I/O function type for setting the Tx line */
+typedef void (*swUartHwSetTxFct)(swUartDataStateE value);
+/** I/O function type for reading the Rx line */
+typedef swUartDataStateE (*swUartHwGetRxFct)(void);
+
+/** \brief swUART configuration structure
+ *
+ * this structure is to be set to user values and will be passed to initializer that will keep
+ * a reference on it
+ * \note though theoretically, \p bitWith should be a \c dword, it is declared a word to save some space
+ * in this structure and in the module management\n
+ * the fact is it has been estimated extremely unlikely to deal with bit rates imposing this value to be
+ * above 65,535
+ * \warning \p bitWidth has restrictions! See #swUartSendInit and #swUartReceiveInit
+ */
+typedef struct _swUartConfigurationT
+{
+ word bitWidth; /**< duration of one bit, unit is timer reload value */
+ swUartStopBitsE stop; /**< number of stop bits: 1 or 2 */
+ swUartParityE parity; /**< type of parity: none, even, or odd */
+ byte nbBits; /**< number of bits to serialize: 3 to 10 */
+ boolean bTripleScan; /**< if each bit is scanned three times on reception (instead of one time) */
+ byte oversampling; /**< samples of each bit on reception: 4, 8 or 16, or 0 to scan as \c bTripleScan says */
+ byte majorityWindow; /**< with \c oversampling: odd number of samples in the middle of a bit voting for its level,
+                           less than \c oversampling (0 for 3) */
+ byte bitWidthFraction; /**< 256ths of a timer tick added to \c bitWidth, for bit rates which are not a whole number
+                             of ticks: delays are whole ticks, the fractions adding up from one to the next */
+}swUartConfigurationT;
+
+/** I/O function type for setting the Tx line of a channel of a group */
+typedef void (*swUartGroupSetTxFct)(word channel, swUartDataStateE value);
+/** I/O function type for reading the Rx line of a channel of a group */
+typedef swUartDataStateE (*swUartGroupGetRxFct)(word channel);
+
+/************************************************************
+ * channel tables: their fields are private to the module
+ ************************************************************/
+
+/* for space constraints environments can be set to byte.
+   in this case characters more than 8-bit wide will be trimmed to a byte */
+#define RCPT_FIFO_TYPE          word /* byte or word */
+/* size of the built-in reception FIFO as defined in number of bits:
+ * - 0 for size 1 (2 to the power of 0),
+ * - 1 for size 2,
+ * - 2 for size 4, ...
+ * - up to 16 for size 65536 (maximum value)
+ * larger FIFO's are better provided by the application to the receivers which need them (see #swUartReceiveSetFifo)
+ */
+#define RCPT_FIFO_SIZE_IN_BITS (4) /* so size is 2^RCPT_FIFO_SIZE_IN_BITS */
+#define RCPT_FIFO_SIZE (1 << RCPT_FIFO_SIZE_IN_BITS) /* in case we need the associated size */
+#define RCPT_FIFO_SIZE_MASK (RCPT_FIFO_SIZE - 1) /* divide mask using the '&' operator */
+
+/** largest size of a reception FIFO */
+#define SWUART_MAX_FIFO_SIZE (0x10000UL)
+
+/** ticks of the timer of a group for one bit: \c bitWidth of its channels should be a multiple of it */
+#define SWUART_GROUP_SAMPLES_PER_BIT (4)
+
+/* states of a transmitter, as traced: the line is set to swUSpace_Low or swUMark_High for one bit */
+typedef enum { swUTIdle, swUTSpace, swUTMark } swUartTxStateE;
+/* machine states for reception */
+typedef enum { swURIdle, swURStart, swURSBit, swURParity, swURStop1, swURStop2 } swUartRxStateE;
+
+/*
+ * common part of state machine context
+ */
+typedef struct
+{
+ word serialChar;    /* char/word being serialized */
+ byte timerId;    /* id of gTimer taking care of delays */
+ byte bitPos : 4;  /* what bit is presently processed */
+ byte nbOfBitsSet : 4;  /* for parity calculation */
+ byte carry;    /* 256ths of a tick left over from the last delay, to add to the next one */
+} swUartCommonPartOfStateMachineT;
+
+/*
+ * state machine for transmission
+ */
+typedef struct
+{
+ swUartHwSetTxFct txFct;    /* i/o function for setting Tx line state (mark or space) */
+ swUartCommonPartOfStateMachineT c;    /* common part: serialChar holds the frame left to send, lsb first */
+ byte bInProgress : 1;  /* activity going on */
+} swUartTxStateMachineT;
+
+/*
+ * what a receiver delivers: FIFO queue of incoming characters and reception error
+ * single producer (the receiver) and single consumer (the reader): lock-free
+ */
+typedef struct
+{
+ RCPT_FIFO_TYPE* rxFifo;    /* FIFO queue to store incoming characters: rxFifoBuiltIn or provided storage */
+ word rxFifoSizeMask;    /* size of the FIFO queue minus one, its size being a power of 2 */
+ dword rxFifoWriteIndex;    /* free running count of characters stored: written by the receiver only */
+ dword rxFifoReadIndex;    /* free running count of characters read: written by the reader only */
+ byte error;    /* reception error: set by the receiver, cleared by the reader */
+ RCPT_FIFO_TYPE rxFifoBuiltIn[RCPT_FIFO_SIZE];    /* storage used unless some is provided */
+} swUartRxFifoT;
+
+/*
+ * state machine for reception
+ */
+typedef struct
+{
+ swUartRxStateE state;    /* machine state */
+ swUartHwGetRxFct rxFct;    /* i/o function for reading Rx line state (mark or space) */
+ swUartCommonPartOfStateMachineT c;    /* common part between Tx and Rx state machines */
+ swUartRxFifoT f;    /* characters received */
+ byte bInProgress : 1;  /* activity going on */
+ byte dontStore : 1;  /* We got an error: don't store serialized value */
+ byte scanPosition : 5;  /* sub state when scanning Rx state multiple times: sample in the bit */
+ byte scanValues : 4;  /* where to store scanned values: samples of the majority window at mark */
+ byte lastSample : 1;  /* level of the previous sample, to see edges */
+ byte errors : 3;  /* errors of the character being received, for its frame */
+ byte bMultidrop : 1;  /* only characters following a matching address are stored */
+ byte bSelected : 1;  /* in multidrop mode: last address matched */
+ word address;    /* in multidrop mode: address of the receiver, without the address bit */
+ word addressMask;    /* in multidrop mode: bits of the address which are compared */
+} swUartRxStateMachineT;
+
+/** \brief block of characters queued for transmission by #swUartSendBlock, owned by the caller
+ *
+ * Characters are taken from \c data where they are, one by one as the previous one ends: the block should be left
+ * untouched until \c index reaches \c size. It can then be reused, or queued again with \c index set back to 0
+ */
+typedef struct _swUartTxBlockT
+{
+ const void* data;    /**< array of bytes if \c nbBits of the configuration is less than 9, of words otherwise */
+ word size;    /**< number of characters in \c data */
+ volatile word index;    /**< characters taken so far: set to 0 to queue the block, done when equal to \c size */
+ struct _swUartTxBlockT* pNext;    /* next block in the queue */
+} swUartTxBlockT;
+
+/** \brief **frame delimited by a silence of the line**, as queued by a receiver (see #swUartReceiveSetFrames) */
+typedef struct _swUartFrameT
+{
+ dword start; /**< free running count of characters stored in the FIFO before the first one of the frame */
+ dword length; /**< number of characters of the frame stored in the FIFO */
+ byte errors; /**< errors of its characters: bits of #swUartErrorBitDefinitionE, stored or not */
+} swUartFrameT;
+
+/** \brief transmitter, in a table of a group (see #swUartGroupCtor) */
+typedef struct _swUartTxStruct
+{
+ const swUartConfigurationT* pCfg;    /* configuration */
+ swUartTxStateMachineT sm;    /* state machine */
+ word countdown;    /* in a group: ticks of its timer to the next bit */
+ swUartTxBlockT* pFirstBlock;    /* queue of blocks to send, taken from by the state machine */
+ swUartTxBlockT* pLastBlock;    /* where blocks are queued */
+} swUartTxChannelT;
+
+/** \brief receiver, in a table of a group (see #swUartGroupCtor) */
+typedef struct _swUartRxStruct
+{
+ const swUartConfigurationT* pCfg;    /* configuration */
+ swUartRxStateMachineT sm;    /* state machine */
+ word countdown;    /* in a group: ticks of its timer to the next bit */
+ dword sampleStep;    /* when oversampling: 256ths of a tick between samples */
+ byte samplesPerBit;    /* when oversampling: samples of each bit, 0 otherwise */
+ byte windowFirst;    /* when oversampling: first sample of a bit to vote, sample 0 being on its edge */
+ byte windowLast;    /* when oversampling: last sample to vote, on which the level of the bit is decided */
+ swUartConfigurationT* pAutobaudCfg;    /* in autobaud mode: pCfg, where the bit width measured is written */
+ word run;    /* in autobaud mode: ticks since the last edge */
+ word shortest;    /* in autobaud mode: shortest run between edges of the first pass */
+ dword runTotal;    /* in autobaud mode: ticks of the runs of one bit of the second pass */
+ byte runCount;    /* in autobaud mode: number of these runs */
+ byte edgesToGo;    /* in autobaud mode: edges left in this pass */
+ byte nbOfEdges;    /* in autobaud mode: edges of each pass */
+ byte autobaudStep;    /* in autobaud mode: step of the measure */
+ swUartFrameT* frames;    /* with frame delimiting: queue of frames closed by the receiver, NULL otherwise */
+ word framesSizeMask;    /* size of this queue minus one, its size being a power of 2 */
+ dword frameWriteIndex;    /* free running count of frames queued: written by the receiver only */
+ dword frameReadIndex;    /* free running count of frames read: written by the reader only */
+ dword frameFirst;    /* characters stored in the FIFO before the frame going on */
+ byte frameErrors;    /* errors of the frame going on */
+ byte idleTenths;    /* silence closing a frame, in tenths of a character */
+} swUartRxChannelT;
+
+/** one bit per line in the samples of a bit-sliced receiver: line \c n is bit \c n, high for mark */
+typedef dword swUartSliceMaskT;
+/** number of lines of a bit-sliced receiver: 32, or 64 on hosts where \c dword is 64-bit */
+#define SWUART_SLICE_LINES (8 * sizeof(swUartSliceMaskT))
+/** samples of a character at most: start, 10 data bits, parity, 2 stop bits */
+#define SWUART_SLICE_MAX_FRAME (14)
+
+/** I/O function type for reading all the Rx lines of a bit-sliced receiver at once */
+typedef swUartSliceMaskT (*swUartSliceGetRxFct)(void);
+
+/** \brief line of a bit-sliced receiver: what it received (see #swUartSliceCtor) */
+typedef swUartRxFifoT swUartSliceLineT;
+
+/** \brief **bit-sliced receiver**
+ *
+ * Built by #swUartSliceCtor: its fields are private to the module
+ */
+typedef struct _swUartSliceT
+{
+ const swUartConfigurationT* pCfg;    /* configuration of all lines */
+ swUartSliceLineT* lines;    /* table of lines */
+ swUartSliceGetRxFct rxFct;    /* reads all lines, NULL if samples are given by swUartSliceOnSample */
+ swUartSliceMaskT enabled;    /* lines which are received */
+ swUartSliceMaskT busy;    /* lines receiving a character */
+ swUartSliceMaskT phase[SWUART_GROUP_SAMPLES_PER_BIT];    /* lines sampled on each tick rank of a bit */
+ swUartSliceMaskT count[4];    /* bit planes of the number of samples taken of the character of each line */
+ swUartSliceMaskT frame[SWUART_SLICE_MAX_FRAME];    /* bit planes of the samples of the character of each line */
+ byte frameLength;    /* samples of a character: start, data, parity and stop bits */
+ byte tick;    /* rank of present tick in a bit */
+} swUartSliceT;
+
+/** \brief **edge receiver**
+ *
+ * Built by #swUartEdgeCtor: its fields are private to the module
+ */
+typedef struct _swUartEdgeT
+{
+ const swUartConfigurationT* pCfg;    /* configuration */
+ swUartRxFifoT f;    /* characters received */
+ dword frameStart;    /* time of the edge of the start bit of the character being received */
+ word frame;    /* levels of the bits of this character known so far, start bit first */
+ byte nbOfBits;    /* how many */
+ byte frameLength;    /* bits of a character: start, data, parity and stop bits */
+ byte level;    /* level of the line since its last edge */
+ byte bInFrame;    /* a character is being received */
+} swUartEdgeT;
+
+/** \brief **samples of a line recorded at a fixed rate**, as read by #swUartDecodeCapture */
+typedef struct _swUartCaptureT
+{
+ const byte* samples; /**< samples, oldest first */
+ dword nbOfSamples; /**< number of samples */
+ byte bitsPerSample; /**< 1: eight samples per byte, oldest in bit 0, or 8: one sample per byte */
+ byte channel; /**< with 8-bit samples, bit of each sample which gives the level of the line (0 to 7) */
+} swUartCaptureT;
+
+/** \brief **character decoded from a capture** */
+typedef struct _swUartDecodedCharT
+{
+ dword position; /**< sample on which its start bit begins */
+ word ch; /**< its data bits, kept even with errors */
+ byte errors; /**< its errors: bits of #swUartErrorBitDefinitionE (framing, parity) */
+} swUartDecodedCharT;
+
+/** \brief **group of channels sharing one timer**
+ *
+ * Built by #swUartGroupCtor: its fields are private to the module
+ */
+typedef struct _swUartGroupT
+{
+ swUartTxChannelT* txChannels;    /* table of transmitters */
+ swUartRxChannelT* rxChannels;    /* table of receivers */
+ word nbOfTx;    /* number of transmitters */
+ word nbOfRx;    /* number of receivers */
+ swUartGroupSetTxFct txFct;    /* sets the Tx line of a channel */
+ swUartGroupGetRxFct rxFct;    /* reads the Rx line of a channel */
+ word bitWidth;    /* of all channels */
+ byte timerId;    /* shared by all channels */
+} swUartGroupT;
+
+/************************************************************
+ * transmission section
+ ************************************************************/
+
+/** \brief initializes a swUART sending state machine
+ *
+ * this initializer should be called before any call to send function with the same \c swUartTxId
+ * \return TRUE if parameters are acceptable (no reference is NULL, \c swUartTxId is within bounds...)
+ * \warning \c bitWidth of configuration parameter should be set to 2 at least (restriction in gTimer)
+ *
+ */
+boolean swUartSendInit(byte swUartTxId /**< swUART Tx index, zero-based */,
+                       const swUartConfigurationT* pConfig /**< reference to configuration parameters */,
+                       byte timerId /**< index of the generic timer that will controls proper delays */,
+                       swUartHwSetTxFct txFct /**< I/O function to set a space or a break position */);
+
+/** \brief sends a character through a state machine of identifier \p swUartTxId
+ *
+ * \note \p ch is a word because more than 8 bits can be sent if configuration is such
+ * \return \c TRUE if \p ch is being serialized, essentially if sending state machine is not busy and correctly initialized
+ */
+boolean swUartSendChar(byte swUartTxId /**< swUart Tx index, zero-based */, word ch /**< character to be serialized */);
+
+/** \brief not available for transmit
+ *
+ * \return \c TRUE if transmission is busy and would not accept sending something
+ */
+boolean swUartSendIsBusy(byte swUartTxId /**< swUart Tx index, zero-based */);
+
+/** \brief sends a stream of data
+ *
+ * sends a stream of data of size \p dataSz \n
+ * the caller must provide reference to a word which stores where we are in the sending: \p pIndex \n
+ * the value at this reference address must be set to zero
+ * \note what \p data references is an array of bytes if field \c nbBits in configuration structure
+ * \ref swUartConfigurationT is less than 9 and it is an array of _words_ otherwise
+ * \note #swUartSendBlock does the same without polling, and with no gap between characters
+ * \return \c TRUE when send streaming is completed
+ */
+boolean swUartSendData(byte swUartTxId /**< swUart Tx index, zero-based */,
+                       const void* data /**< data to send, array of bytes or words depending on \c nbBits */,
+                       word dataSz /**< number of data items to send */,
+                       word* pIndex /**< reference to where we are in the sending */);
+
+/** \brief queues a block of characters to be sent without further calls
+ *
+ * The state machine takes the next character from the queue as soon as the stop bit of the previous one ends,
+ * so characters and blocks go out back to back, without any gap, whenever the main loop runs. Characters are not
+ * copied: \p pBlock stays in use until its \c index reaches its \c size\n
+ * Unlike #swUartSendData, nothing has to be polled: #swUartSendIsBusy tells when the whole queue has been sent
+ * \note when the callbacks of \c gTimer run in an interrupt, \c SWUART_ENTER_CRITICAL and \c SWUART_EXIT_CRITICAL
+ * should be defined (in \c system.h) to mask it while the block is linked to the queue
+ * \return \c FALSE if \p swUartTxId is not initialized or \p pBlock is \c NULL
+ */
+boolean swUartSendBlock(byte swUartTxId /**< swUart Tx index, zero-based */,
+                        swUartTxBlockT* pBlock /**< block with \c data, \c size, and \c index set to 0 */);
+
+/************************************************************
+ * reception section
+ ************************************************************/
+
+/** \brief initializes a swUART receiving state machine and logics
+ *
+ * this initializer should be called before any call to receive function with the same \p swUartRxId
+ * \return TRUE if parameters are acceptable (no reference is NULL, \p swUartRxId is within bounds...)
+ * With \c oversampling, the line is sampled that many times per bit. The level of each bit is decided by a majority
+ * of the \c majorityWindow samples in its middle, and every falling edge seen outside this window (start bit or
+ * data bits) resynchronizes sampling on it, so that a receiver may be somewhat off the rate of the transmitter.
+ * Timings are computed once here. \c bTripleScan is the same as an \c oversampling of 4 with a window of 3
+ * \warning configuration parameter \c bitWidth has restrictions (with any \c bitWidthFraction):
+ * - should be _4_ at least without \c oversampling and if configuration parameter \c bTripleScan is \c FALSE
+ * - should be _8_ at least if configuration parameter \c bTripleScan is \c TRUE
+ * - should be twice \c oversampling at least otherwise
+ */
+boolean swUartReceiveInit(byte swUartRxId /**< swUART Rx index, zero-based */,
+                          const swUartConfigurationT* pCfg /**< reference to configuration parameters */,
+                          byte timerId /**< index of the generic timer that will controls proper delays */,
+                          swUartHwGetRxFct rxFct /**< I/O function to sense a space or a break position */);
+
+/** \brief initializes a swUART receiver which finds out its bit width by itself
+ *
+ * Same as #swUartReceiveInit, except that \c bitWidth and \c bitWidthFraction of \p pCfg are measured on the line,
+ * then written to \p pCfg.
+ * Until then it reads 0 and the line is sampled on every tick of \p timerId. Runs of the line between its edges are
+ * measured: the shortest run of \p nbOfEdges edges is about a bit, and the bit width is the mean of the runs of the
+ * next \p nbOfEdges edges which are about as long, to a 256th of a tick. It should be as large as the scanning
+ * options of \p pCfg require (see #swUartReceiveInit). The measure starts over on a glitch, a run much shorter than
+ * the first shortest one. Once the line has been idle for a character, reception goes on as with #swUartReceiveInit\n
+ * The first characters are used up by the measure. Characters with single-bit pulses, like a few \c 'U' (0x55)
+ * sent as a sync, make it quick and safe; they should be followed by a pause
+ * \return \c TRUE if parameters are acceptable, \p nbOfEdges being 2 at least
+ */
+boolean swUartReceiveAutobaud(byte swUartRxId /**< swUART Rx index, zero-based */,
+                              swUartConfigurationT* pCfg /**< configuration parameters, with \c bitWidth to be set */,
+                              byte timerId /**< index of the generic timer that will controls proper delays */,
+                              swUartHwGetRxFct rxFct /**< I/O function to sense a space or a break position */,
+                              byte nbOfEdges /**< edges of each pass of the measure, 10 in one \\c 'U' of 8 bits */);
+
+/** \brief test the reception line and engage the reception state machine when start condition sensed
+ *
+ * this function has to be called as often as possible to test whether a start condition on the reception line has occurred\n
+ * if a start condition has occurred the reception state machine is primed\n
+ * it can be safely called when a reception is already under way
+ * \return \c TRUE iff a start condition has just been sensed
+ */
+boolean swUartReceiveScanForStart(byte swUartRxId /**< swUart Tx index, zero-based */);
+
+/** \brief returns the least recently received character leaving the FIFO unaffected
+ *
+ * can be used to test if some character is ready to be read
+ * \return most recent character or 0xffff if reception FIFO is empty (or if an error occurred)
+ */
+word swUartPeekChar(byte swUartRxId /**< swUART Rx index, zero-based */);
+
+/** \brief returns the nth received character leaving the FIFO unaffected
+ *
+ * least recently received character is of rank zero
+ * \return the targeted character or 0xffff if reception FIFO is empty (or if an error occurred)
+ */
+word swUartPeekNChar(byte swUartRxId /**< swUART Rx index, zero-based */, word nth /**< zero-based rank of character */);
+
+/** \brief number of characters available in the reception FIFO
+ *
+ * \return this number - zero returned not only when FIFO is empty but also in case of error
+ */
+dword swUartHowManyChars(byte swUartRxId /**< swUART Rx index, zero-based */);
+
+/** \brief empties the reception FIFO
+ */
+void swUartFlushChars(byte swUartRxId /**< swUART Rx index, zero-based */);
+
+/** \brief pulls available character from the reception FIFO
+ *
+ * this character is the least recently received
+ * \return this character and 0xffff in case of error or if FIFO is empty
+ */
+word swUartGetChar(byte swUartRxId /**< swUART Rx index, zero-based */);
+
+/** \brief pulls as many available characters as possible from the reception FIFO at once
+ *
+ * Characters are copied in one go, least recently received first: with two \c memcpy at most, the second one when
+ * they wrap around the end of the FIFO
+ * \return number of characters copied to \p dst, zero if FIFO is empty or in case of error
+ */
+dword swUartReadBuffer(byte swUartRxId /**< swUART Rx index, zero-based */,
+                       RCPT_FIFO_TYPE* dst /**< where to copy characters */,
+                       dword max /**< largest number of characters to copy */);
+
+/** \brief gives a receiver a FIFO of its own size, in storage provided by the caller
+ *
+ * To be called after #swUartReceiveInit, which sets the built-in FIFO of \c RCPT_FIFO_SIZE characters back.
+ * The FIFO is emptied
+ * \return \c TRUE if \p size is a power of 2 up to #SWUART_MAX_FIFO_SIZE and \p storage is not \c NULL
+ */
+boolean swUartReceiveSetFifo(byte swUartRxId /**< swUART Rx index, zero-based */,
+                             RCPT_FIFO_TYPE* storage /**< room for \p size characters, used until next init */,
+                             dword size /**< number of characters the FIFO can hold */);
+
+/** \brief return the error value and possibly clear it
+ *
+ * the error is a bit-field with bit set according to definitions stated in \b swUartErrorBitDefinitionE
+ * \return value of the error before it is possibly cleared
+ */
+boolean swUartReceiveGetAndClearError(byte swUartRxId /**< swUart Tx index, zero-based */,
+                                      boolean bClearError /**< \c TRUE, should the error be cleared */);
+
+/** \brief makes a receiver keep only the characters addressed to it on a multidrop bus, or all of them
+ *
+ * In multidrop mode, the last data bit of a character (the 9th one with \c nbBits 9) tells an address from data. An
+ * address selects the receiver if its other bits match \p address on the bits set in \p mask (0 for any address),
+ * and deselects it otherwise, or if it comes with errors. Addresses which select the receiver, with their address bit,
+ * and the data which follows them are stored in the FIFO: what comes while the receiver is not selected is dropped,
+ * before it reaches the FIFO. Errors are reported for all characters\n
+ * The receiver is not selected until an address selects it
+ * \note to be called after #swUartReceiveInit or #swUartReceiveAutobaud, which turn multidrop mode off
+ * \return \c FALSE if \p swUartRxId is not initialized
+ */
+boolean swUartReceiveSetAddress(byte swUartRxId /**< swUART Rx index, zero-based */,
+                                boolean bMultidrop /**< \c TRUE for multidrop mode, \c FALSE to keep all characters */,
+                                word address /**< address of the receiver, without the address bit */,
+                                word mask /**< bits of addresses compared with \p address */);
+
+/** \brief makes a receiver delimit frames by the silences of its line, in a queue provided by the caller
+ *
+ * Once the line has been idle for \p idleTenths tenths of a character (35 for the 3.5 characters of Modbus RTU) after
+ * the end of a character, the frame of the characters received since the last one is closed: its descriptor is
+ * queued, to be read by #swUartGetFrame, and its characters are in the FIFO, to be read by #swUartReadBuffer for
+ * instance. Characters with errors are not stored but their errors are reported in the frame. A frame lost because
+ * the queue is full sets the overrun error of the receiver\n
+ * The silence is timed by the timer of the receiver, which goes on after each character for that long: the main loop
+ * does not have to poll anything but #swUartReceiveScanForStart
+ * \note to be called after #swUartReceiveInit or #swUartReceiveAutobaud, which turn frame delimiting off. The queue
+ * is emptied, and the next frame begins with the next character
+ * \return \c TRUE if \p storage is \c NULL, which turns frame delimiting off, or if \p size is a power of 2 up to
+ * #SWUART_MAX_FIFO_SIZE and \p idleTenths is not 0
+ */
+boolean swUartReceiveSetFrames(byte swUartRxId /**< swUART Rx index, zero-based */,
+                               swUartFrameT* storage /**< room for \p size frames, used until next init, or \c NULL */,
+                               dword size /**< number of frames the queue can hold */,
+                               byte idleTenths /**< silence closing a frame, in tenths of a character */);
+
+/** \brief number of frames in the queue of a receiver (see #swUartReceiveSetFrames) */
+dword swUartHowManyFrames(byte swUartRxId /**< swUART Rx index, zero-based */);
+
+/** \brief pulls the least recently closed frame from the queue of a receiver
+ *
+ * \return \c FALSE if the queue is empty or if the receiver does not delimit frames
+ */
+boolean swUartGetFrame(byte swUartRxId /**< swUART Rx index, zero-based */,
+                       swUartFrameT* pFrame /**< where to copy the frame */);
+
+/************************************************************
+ * group section
+ ************************************************************/
+
+/** \brief constructs a group of channels sharing one timer
+ *
+ * Channels of the tables are not configured: each of them should be initialized with #swUartGroupSendInit or
+ * #swUartGroupReceiveInit before it is used\n
+ * The timer (a reserved \ref gTimer with callback) is started at once and runs as long as the group is used, as
+ * receivers look for start bits on each of its ticks: one every \p bitWidth / #SWUART_GROUP_SAMPLES_PER_BIT ticks
+ * of \ref gTimer
+ * \return \c TRUE if parameters are acceptable: \p bitWidth should be a multiple of #SWUART_GROUP_SAMPLES_PER_BIT,
+ * twice at least (restriction in gTimer)
+ */
+boolean swUartGroupCtor(swUartGroupT* This /**< group to construct */,
+                        word bitWidth /**< duration of one bit of all channels, unit is timer reload value */,
+                        byte timerId /**< index of the generic timer shared by all channels */,
+                        swUartTxChannelT* txChannels /**< table of transmitters, may be \c NULL if there are none */,
+                        word nbOfTx /**< number of entries of \p txChannels */,
+                        swUartGroupSetTxFct txFct /**< I/O function to set the Tx line of a channel */,
+                        swUartRxChannelT* rxChannels /**< table of receivers, may be \c NULL if there are none */,
+                        word nbOfRx /**< number of entries of \p rxChannels */,
+                        swUartGroupGetRxFct rxFct /**< I/O function to sense the Rx line of a channel */);
+
+/** \brief see #swUartSendInit: \c bitWidth of \p pCfg should be the one of the group, with no \c bitWidthFraction */
+boolean swUartGroupSendInit(swUartGroupT* This /**< group */,
+                            word txId /**< zero-based index in the transmitters of the group */,
+                            const swUartConfigurationT* pCfg /**< reference to configuration parameters */);
+
+/** \brief see #swUartSendChar */
+boolean swUartGroupSendChar(swUartGroupT* This /**< group */, word txId /**< transmitter */,
+                            word ch /**< character to be serialized */);
+
+/** \brief see #swUartSendBlock */
+boolean swUartGroupSendBlock(swUartGroupT* This /**< group */, word txId /**< transmitter */,
+                             swUartTxBlockT* pBlock /**< block with \c data, \c size, and \c index set to 0 */);
+
+/** \brief see #swUartSendIsBusy */
+boolean swUartGroupSendIsBusy(swUartGroupT* This /**< group */, word txId /**< transmitter */);
+
+/** \brief see #swUartReceiveInit: \c bitWidth of \p pCfg should be the one of the group, with no \c bitWidthFraction
+ *
+ * Each bit is scanned once, in its middle: \c bTripleScan should be \c FALSE, and \c oversampling 0
+ */
+boolean swUartGroupReceiveInit(swUartGroupT* This /**< group */,
+                               word rxId /**< zero-based index in the receivers of the group */,
+                               const swUartConfigurationT* pCfg /**< reference to configuration parameters */);
+
+/** \brief see #swUartReceiveSetAddress: to be called after #swUartGroupReceiveInit */
+boolean swUartGroupReceiveSetAddress(swUartGroupT* This /**< group */, word rxId /**< receiver */,
+                                     boolean bMultidrop /**< \c TRUE for multidrop mode, \c FALSE to keep all characters */,
+                                     word address /**< address of the receiver, without the address bit */,
+                                     word mask /**< bits of addresses compared with \p address */);
+
+/** \brief see #swUartPeekChar */
+word swUartGroupPeekChar(swUartGroupT* This /**< group */, word rxId /**< receiver */);
+
+/** \brief see #swUartPeekNChar */
+word swUartGroupPeekNChar(swUartGroupT* This /**< group */, word rxId /**< receiver */,
+                          word nth /**< zero-based rank of character */);
+
+/** \brief see #swUartHowManyChars */
+dword swUartGroupHowManyChars(swUartGroupT* This /**< group */, word rxId /**< receiver */);
+
+/** \brief see #swUartFlushChars */
+void swUartGroupFlushChars(swUartGroupT* This /**< group */, word rxId /**< receiver */);
+
+/** \brief see #swUartGetChar */
+word swUartGroupGetChar(swUartGroupT* This /**< group */, word rxId /**< receiver */);
+
+/** \brief see #swUartReadBuffer */
+dword swUartGroupReadBuffer(swUartGroupT* This /**< group */, word rxId /**< receiver */,
+                            RCPT_FIFO_TYPE* dst /**< where to copy characters */,
+                            dword max /**< largest number of characters to copy */);
+
+/** \brief see #swUartReceiveSetFifo: to be called after #swUartGroupReceiveInit */
+boolean swUartGroupReceiveSetFifo(swUartGroupT* This /**< group */, word rxId /**< receiver */,
+                                  RCPT_FIFO_TYPE* storage /**< room for \p size characters */,
+                                  dword size /**< number of characters the FIFO can hold */);
+
+/** \brief see #swUartReceiveGetAndClearError */
+byte swUartGroupReceiveGetAndClearError(swUartGroupT* This /**< group */, word rxId /**< receiver */,
+                                        boolean bClearError /**< \c TRUE, should the error be cleared */);
+
+/************************************************************
+ * bit-sliced reception section
+ ************************************************************/
+
+/** \brief constructs a bit-sliced receiver of up to #SWUART_SLICE_LINES lines with the same configuration
+ *
+ * With \p rxFct, the receiver is run by its timer (a reserved \ref gTimer with callback), started at once, on
+ * which it reads the port: #SWUART_GROUP_SAMPLES_PER_BIT times per bit. Otherwise, the application gives it samples
+ * at this rate with #swUartSliceOnSample\n
+ * Each bit is scanned once, in its middle
+ * \return \c TRUE if parameters are acceptable: \c bTripleScan of \p pCfg should be \c FALSE, \c oversampling 0,
+ * \c bitWidthFraction 0, and with \p rxFct its \c bitWidth should be a multiple of #SWUART_GROUP_SAMPLES_PER_BIT,
+ * twice at least (restriction in gTimer)
+ */
+boolean swUartSliceCtor(swUartSliceT* This /**< receiver to construct */,
+                        const swUartConfigurationT* pCfg /**< reference to configuration parameters of all lines */,
+                        swUartSliceLineT* lines /**< table of lines */,
+                        byte nbOfLines /**< number of entries of \p lines: lines 0 to \p nbOfLines - 1 are received */,
+                        byte timerId /**< index of the generic timer of the receiver, unused without \p rxFct */,
+                        swUartSliceGetRxFct rxFct /**< I/O function to read all lines, or \c NULL */);
+
+/** \brief advances all the lines of a bit-sliced receiver by one tick, when it is not run by its timer */
+void swUartSliceOnSample(swUartSliceT* This /**< receiver */,
+                         swUartSliceMaskT sample /**< level of all lines, one bit per line, high for mark */);
+
+/** \brief see #swUartHowManyChars */
+dword swUartSliceHowManyChars(swUartSliceT* This /**< receiver */, byte line /**< zero-based line */);
+
+/** \brief see #swUartGetChar */
+word swUartSliceGetChar(swUartSliceT* This /**< receiver */, byte line /**< zero-based line */);
+
+/** \brief see #swUartReadBuffer */
+dword swUartSliceReadBuffer(swUartSliceT* This /**< receiver */, byte line /**< zero-based line */,
+                            RCPT_FIFO_TYPE* dst /**< where to copy characters */,
+                            dword max /**< largest number of characters to copy */);
+
+/** \brief see #swUartReceiveSetFifo: to be called after #swUartSliceCtor */
+boolean swUartSliceSetFifo(swUartSliceT* This /**< receiver */, byte line /**< zero-based line */,
+                           RCPT_FIFO_TYPE* storage /**< room for \p size characters */,
+                           dword size /**< number of characters the FIFO can hold */);
+
+/** \brief see #swUartFlushChars */
+void swUartSliceFlushChars(swUartSliceT* This /**< receiver */, byte line /**< zero-based line */);
+
+/** \brief see #swUartReceiveGetAndClearError */
+byte swUartSliceGetAndClearError(swUartSliceT* This /**< receiver */, byte line /**< zero-based line */,
+                                 boolean bClearError /**< \c TRUE, should the error be cleared */);
+
+/************************************************************
+ * edge reception section
+ ************************************************************/
+
+/** \brief constructs a receiver which decodes characters from the times of the edges of its line
+ *
+ * Times are in any unit, \c bitWidth of \p pCfg (plus \c bitWidthFraction 256ths) being the duration of one bit in
+ * this unit, as long as two edges are never more than 2^31 apart. Each bit takes the level the line had in its middle, which gives the same
+ * characters and the same framing, parity and overrun errors as #swUartReceiveInit with one scan per bit
+ * \return \c TRUE if parameters are acceptable: \c bTripleScan of \p pCfg should be \c FALSE and \c oversampling 0
+ */
+boolean swUartEdgeCtor(swUartEdgeT* This /**< receiver to construct */,
+                       const swUartConfigurationT* pCfg /**< reference to configuration parameters */);
+
+/** \brief gives an edge receiver the time at which its line changed
+ *
+ * Edges should be given in time order. A level equal to the present one is taken as no edge
+ */
+void swUartEdgeOnEdge(swUartEdgeT* This /**< receiver */, dword time /**< time of the edge */,
+                      swUartDataStateE level /**< level of the line from then on */);
+
+/** \brief tells an edge receiver the line has not changed until now
+ *
+ * A character whose last bits are at mark ends without any edge: it is stored once this is called with a time
+ * at or past the middle of its last stop bit (at the latest when the start bit of the next character is given)
+ */
+void swUartEdgeOnTime(swUartEdgeT* This /**< receiver */, dword now /**< present time */);
+
+/** \brief see #swUartHowManyChars */
+dword swUartEdgeHowManyChars(swUartEdgeT* This /**< receiver */);
+
+/** \brief see #swUartGetChar */
+word swUartEdgeGetChar(swUartEdgeT* This /**< receiver */);
+
+/** \brief see #swUartReadBuffer */
+dword swUartEdgeReadBuffer(swUartEdgeT* This /**< receiver */, RCPT_FIFO_TYPE* dst /**< where to copy characters */,
+                           dword max /**< largest number of characters to copy */);
+
+/** \brief see #swUartFlushChars */
+void swUartEdgeFlushChars(swUartEdgeT* This /**< receiver */);
+
+/** \brief see #swUartReceiveGetAndClearError */
+byte swUartEdgeGetAndClearError(swUartEdgeT* This /**< receiver */,
+                                boolean bClearError /**< \c TRUE, should the error be cleared */);
+
+/************************************************************
+ * capture decoding section
+ ************************************************************/
+
+/** \brief decodes the characters of a capture
+ *
+ * \c bitWidth of \p pCfg (plus \c bitWidthFraction 256ths) is the number of samples of one bit. A character begins
+ * on any sample at space following one at mark (the sample before \p pPosition counts, there is no sample before the
+ * first one) and each of its bits takes the sample in its middle. A start bit back to mark in its middle is taken as
+ * a glitch. Framing and parity errors are reported for each character. Scanning options of \p pCfg are not used\n
+ * Captures too large for memory can be decoded piece by piece: decoding stops on the first character which does not
+ * end in \p pCapture, and \p pPosition tells where to go on from, in the same capture made longer or in a next
+ * piece which begins on that sample or a little before it (on a byte boundary with 1-bit samples), \p pPosition being
+ * made relative to that piece
+ * \return number of characters decoded, 0 if parameters are not acceptable
+ */
+dword swUartDecodeCapture(const swUartConfigurationT* pCfg /**< reference to configuration parameters */,
+                          const swUartCaptureT* pCapture /**< samples to decode */,
+                          dword* pPosition /**< sample to start from, updated to where decoding should go on */,
+                          swUartDecodedCharT* pChars /**< where to store characters */,
+                          dword maxChars /**< largest number of characters to store */);
+
+/************************************************************
+ * some more details for doxygen
+ ************************************************************/
+
+/**
+ * \}
+ * \addtogroup swUart
+ * How to
+ * ======
+ * In order to illustrate a typical use of this module for both transmission and reception,
+ * some code snippets for one UART are presented here\n
+ * First implement <tt>void setTxOutput(swUartDataStateE s)</tt> and <tt>swUartDataStateE getRxInput(void)</tt> to
+ * inform the module how to handle transmission and reception actual signals. E.g.
+ * \code
+void setTxOutput(swUartDataStateE s)
+ {
+  _setIo(XX, s==swUSpace_Low?0:1);
+ }
+swUartDataStateE getRxInput(void)
+ {
+  return(_getIo(XY)==0?swUSpace_Low:swUMark_High);
+ }
+ * \endcode
+ * Then initialize soft timer manager, dedicate two timers for Tx and Rx, and initialize TX and Rx with
+ * a configuration structure. Timer ID's have to be defined in header file: \c system.h
+ * \code
+const byte uartIdx=0;
+swUartConfigurationT swUartCfg={
+     nbBits:8, parity:swUEvenParity, stop:swU2Stop, bitWidth:4, bTripleScan:FALSE};
+gtimerInitModule();
+gtimerReserve(SWUART1_TX_TIMER_ID);
+gtimerReserve(SWUART1_RX_TIMER_ID);
+swUartSendInit(uartIdx, &swUartCfg, SWUART1_TX_TIMER_ID, setTxOutput);
+swUartReceiveInit(uartIdx, &swUartCfg, SWUART1_RX_TIMER_ID, getRxInput);
+ * \endcode
+ * Follows a test example implemented in the \c main loop. This example constantly send the same string over and over again
+ * and tries to catch what is sent to display it. Two strategies to used to read the incoming stream:
+ * - #swUartGetChar to pull characters one by one from the FIFO
+ * - have a look into the FIFO with #swUartHowManyChars, #swUartPeekNChar, and flush it with #swUartFlushChars
+ *
+ * Call to #swUartReceiveScanForStart is necessary to start the Rx state machine which is managed by the timer\n
+ * It is interesting noting this example directly or indirectly calls almost all the methods of this module
+ * \code
+while(1)
+{
+   static word index=0;
+   static char* pCh="Hello world!\n"; // be careful: RCPT_FIFO_SIZE_IN_BITS should be 4 or more in swUart module
+   static boolean bUsePeek=FALSE; // flag to alternate use of PeekN and GetChar to read received chars
+   byte n, p;
+   word ch;
+
+    if(gtimerPendingTicks) // ticks counted by timer interrupt
+     gtimerOnTick(); // manages gTimer
+    // send text gradually until returns TRUE, indicating all is done
+    if(swUartSendData(uartIdx, pCh, strlen(pCh), &index))
+     index=0; // sends over and over again
+    swUartReceiveScanForStart(0); // scans start condition which will start Rx stat machine
+    if(swUartReceiveGetAndClearError(uartIdx, FALSE)) // scan errors
+    {
+      // this one will read errors and clear them
+      printf("Errors!!! Value: %i\n", (int)swUartReceiveGetAndClearError(uartIdx, TRUE));
+    }
+    if(bUsePeek) // will read inbound characters through 'peek' mechanism
+    {
+     // will peek last received until we got an LF
+     n=swUartHowManyChars(uartIdx);
+     if(n>0)
+     {
+      if(swUartPeekNChar(uartIdx, n-1)=='\n')
+      {
+       // we got the LF: get string through peekNChar function and flush
+       for(p=0; p<n; p++)
+       {
+        ch=swUartPeekNChar(uartIdx, p);
+        printf("Peeked: '%c' - 0x%03x\n", _printable(ch), ch); // _printable returns space if ch is not 'nice'
+       }
+       swUartFlushChars(uartIdx);
+       bUsePeek=FALSE; // switch to getChar method for next string to fetch
+      }
+     }
+    }
+    else
+    {
+     ch=swUartGetChar(uartIdx);
+     if(ch!=0xffff) // char is valid
+     {
+      printf("Received: '%c' - 0x%03x\n", _printable(ch), ch);
+      if(ch=='\n') // got entire string: switch to peek method
+       bUsePeek=TRUE;
+     }
+    }
+}
+ * \endcode
+ */
+
+#endif // __SWUART_H_INCLUDED__
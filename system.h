@@ -6,7 +6,16 @@
 #define SWUART1_RECEIVE_TIMER_ID (1)
 
 #define GTIMER_IMPLEMENTS_CALLBACK
+/* #define GTIMER_IMPLEMENTS_DEFERRED_CALLBACK */ /* callbacks run by gtimerDispatch instead of gtimerOnTick */
+/* #define GTIMER_IMPLEMENTS_SLACK */ /* time-outs may be delayed within a slack to share wake-ups */
+/* #define GTIMER_IMPLEMENTS_NS */ /* Linux: deadlines on CLOCK_MONOTONIC in nanoseconds, no periodic tick */
+/* #define GTIMER_IMPLEMENTS_STATS */ /* lateness and callback duration histograms, see gtimerGetStats */
+/* #define GTIMER_IMPLEMENTS_TRACE */ /* starts, time-outs and callbacks recorded by trace.c */
+/* #define GTIMER_IMPLEMENTS_WHEEL */ /* worth it with many timers */
+/* #define SWUART_IMPLEMENTS_TRACE */ /* bit states, FIFO and errors recorded by trace.c */
 
-#define _N_GTIMERS (2)
+#ifndef _N_GTIMERS
+ #define _N_GTIMERS (2)
+#endif
 
 #endif // __SYSTEM_H_INCLUDED__
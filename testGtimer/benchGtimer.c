@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+/**************************************************
+
+file: benchGtimer.c
+purpose: measures how many gTimer ticks per second can be processed
+         with _N_GTIMERS auto-reload timers running
+         and, when the kernel lets us count them, how many
+         cache misses occur per tick
+         (see benchGtimer.sh which builds it for several
+          pool sizes, with and without GTIMER_IMPLEMENTS_WHEEL)
+
+**************************************************/
+#include "gtimer.h"
+
+#define BENCH_DURATION_S (1.0)
+#define MIN_PERIOD (100) /* periods spread between these two (ticks) */
+#define MAX_PERIOD (100000)
+#ifndef BENCH_RUNNING_EVERY /* one timer out of this number is running, others are allocated but frozen */
+ #define BENCH_RUNNING_EVERY (1)
+#endif
+
+static dword nbOfExpiries;
+
+static dword onExpiry(UNUSED_FCT_P gtimerIdT id, UNUSED_FCT_P dword value)
+{
+ nbOfExpiries++;
+ return 0;
+}
+
+/* opens a hardware cache miss counter (-1 if not available) */
+static int openCacheMissCounter(void)
+{
+#ifdef __linux__
+ struct perf_event_attr attr;
+ memset(&attr, 0, sizeof(attr));
+ attr.size = sizeof(attr);
+ attr.type = PERF_TYPE_HARDWARE;
+ attr.config = PERF_COUNT_HW_CACHE_MISSES;
+ attr.disabled = 1;
+ attr.exclude_kernel = 1;
+ attr.exclude_hv = 1;
+ return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+ return -1;
+#endif
+}
+
+static double now(void)
+{
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+ dword seed = 12345;
+ dword nbOfTicks = 0;
+ double start, elapsed;
+ long long cacheMisses = -1;
+ int counter = openCacheMissCounter();
+ gtimerIdT id;
+
+ gtimerInitModule();
+ for (id = 0; id < _N_GTIMERS; id++)
+  {
+   seed = seed * 1103515245 + 12345;   /* deterministic pseudo random periods */
+   gtimerReserve(id);
+   gtimerSetCallback(id, onExpiry, 0, NULL);
+   gtimerInitAndStart(id, MIN_PERIOD + (seed >> 8) % (MAX_PERIOD - MIN_PERIOD), TRUE);
+   if (id % BENCH_RUNNING_EVERY != 0)
+    {
+     gtimerFreeze(id);
+    }
+  }
+ if (counter >= 0)
+  {
+   ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+   ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+  }
+ start = now();
+ do
+  {
+   word n;
+   for (n = 0; n < 256; n++)
+    {
+     gtimerOnTick();
+    }
+   nbOfTicks += n;
+   elapsed = now() - start;
+  }
+ while (elapsed < BENCH_DURATION_S);
+ if (counter >= 0)
+  {
+   ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+   if (read(counter, &cacheMisses, sizeof(cacheMisses)) != sizeof(cacheMisses))
+    {
+     cacheMisses = -1;
+    }
+   close(counter);
+  }
+ printf("%-6s %7lu timers, 1/%-2d running: %12.0f ticks/s (%lu expiries over %lu ticks)",
+#ifdef GTIMER_IMPLEMENTS_WHEEL
+        "wheel",
+#else
+        "linear",
+#endif
+        (unsigned long)_N_GTIMERS, BENCH_RUNNING_EVERY, nbOfTicks / elapsed, nbOfExpiries, nbOfTicks);
+ if (cacheMisses >= 0)
+  {
+   printf(", %.3f cache misses/tick", (double)cacheMisses / nbOfTicks);
+  }
+ printf("\n");
+ return 0;
+}
@@ -0,0 +1,46 @@
+#!/bin/bash
+# builds and runs benchGtimer.c for several quantities of timers, all of them
+# or one out of 64 running, with the linear scan of gtimerOnTick and with the timing wheel,
+# then benchGtimerPools.c to show how pools scale across cores, benchGtimerSlack.c for
+# the wake-ups saved by slack and benchGtimerNs.c for the lateness of sub-millisecond
+# timers in nanosecond mode, and benchGtimerDispatch.c checks deferred callbacks
+# usage: benchGtimer.sh [extra gcc options]
+
+CC="gcc"
+CFLAGS="-O2 -Wall -I.. $*"
+SRC_DIR="$(dirname "$0")"
+BIN="${TMPDIR:-/tmp}/benchGtimer.$$"
+
+cd "${SRC_DIR}" || exit 1
+for RUNNING in 1 64
+do
+ for N in 10 1000 100000
+ do
+  for ENGINE in "" "-DGTIMER_IMPLEMENTS_WHEEL"
+  do
+   ${CC} ${CFLAGS} -D_N_GTIMERS=${N} -DBENCH_RUNNING_EVERY=${RUNNING} ${ENGINE} ../gtimer.c benchGtimer.c -o "${BIN}" || exit 1
+   "${BIN}"
+  done
+ done
+done
+
+# one private pool per thread
+${CC} ${CFLAGS} -pthread -DGTIMER_IMPLEMENTS_WHEEL -DGTIMER_MAX_POOL_SIZE=100000 \
+ ../gtimer.c benchGtimerPools.c -o "${BIN}" || exit 1
+"${BIN}"
+
+# periodic timers with slack, run tickless
+${CC} ${CFLAGS} -D_N_GTIMERS=300 -DGTIMER_IMPLEMENTS_SLACK -DGTIMER_IMPLEMENTS_WHEEL \
+ ../gtimer.c benchGtimerSlack.c -o "${BIN}" || exit 1
+"${BIN}"
+
+# nanosecond deadlines, no periodic tick
+${CC} ${CFLAGS} -std=c99 -D_N_GTIMERS=4 -DGTIMER_IMPLEMENTS_NS -DGTIMER_IMPLEMENTS_WHEEL \
+ ../gtimer.c benchGtimerNs.c -o "${BIN}" || exit 1
+"${BIN}"
+
+# time-outs queued for a timer released, frozen or started again meanwhile
+${CC} ${CFLAGS} -D_N_GTIMERS=7 -DGTIMER_IMPLEMENTS_DEFERRED_CALLBACK \
+ ../gtimer.c benchGtimerDispatch.c -o "${BIN}" || exit 1
+"${BIN}" || { rm -f "${BIN}"; exit 1; }
+rm -f "${BIN}"
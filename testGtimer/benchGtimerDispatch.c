@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/**************************************************
+
+file: benchGtimerDispatch.c
+purpose: checks deferred callbacks (GTIMER_IMPLEMENTS_DEFERRED_CALLBACK,
+         see benchGtimer.sh which builds and runs it): a time-out
+         still queued when its timer is released or given to a new
+         owner is dropped, one of a timer frozen or started again
+         meanwhile still runs its callback but does not rearm the
+         timer, and a deferred rearm counts from dispatch time
+
+**************************************************/
+#include "gtimer.h"
+
+#define ID_RELEASER (0)   /* its callback releases the next one */
+#define ID_RELEASED (1)   /* times out a tick later, released with its time-out queued, then reserved again */
+#define ID_FROZEN (2)     /* frozen with its time-out queued */
+#define ID_FROZEN_PLAIN (3)   /* same, with a callback which does not rearm */
+#define ID_RESTARTED (4)  /* started again with its time-out queued */
+#define ID_STOPPED (5)    /* same, with a callback which stops it */
+#define ID_LATE (6)       /* rearmed late */
+#define NEW_OWNER (_N_GTIMERS)   /* callback input of the new owner of ID_RELEASED */
+#define DELAY (5)         /* first delay of every timer (ticks) */
+#define REARM (7)         /* delay returned by rearm callbacks (ticks) */
+#define RESTART (1000)    /* delay given when started again (ticks) */
+
+static dword Calls[_N_GTIMERS + 1];   /* callbacks run, per callback input value */
+
+static dword onRearm(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ Calls[value]++;
+ return REARM;
+}
+
+static dword onStop(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ Calls[value]++;
+ return GTIMER_CALLBACK_STOP;
+}
+
+static dword onReleaser(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ Calls[value]++;
+ gtimerRelease(ID_RELEASED);
+ gtimerReserve(ID_RELEASED);                  /* same id, new owner */
+ gtimerSetRearmCallback(ID_RELEASED, onRearm, NEW_OWNER);
+ return GTIMER_CALLBACK_STOP;
+}
+
+static void tick(dword ticks)
+{
+ while (ticks-- > 0)
+  {
+   gtimerOnTick();
+  }
+}
+
+static int check(const char* what, boolean bOk)
+{
+ printf("%-56s %s\n", what, bOk ? "passed" : "FAILED");
+ return bOk ? 0 : 1;
+}
+
+int main(void)
+{
+ int nbFailed = 0;
+ gtimerIdT id;
+
+ gtimerInitModule();
+ for (id = 0; id < _N_GTIMERS; id++)
+  {
+   gtimerReserve(id);
+   gtimerInitAndStart(id, id == ID_RELEASED ? DELAY + 1 : DELAY, FALSE);
+  }
+ gtimerSetRearmCallback(ID_RELEASER, onReleaser, ID_RELEASER);
+ gtimerSetRearmCallback(ID_RELEASED, onRearm, ID_RELEASED);
+ gtimerSetRearmCallback(ID_FROZEN, onRearm, ID_FROZEN);
+ gtimerSetCallback(ID_FROZEN_PLAIN, onRearm, ID_FROZEN_PLAIN, NULL);
+ gtimerSetRearmCallback(ID_RESTARTED, onRearm, ID_RESTARTED);
+ gtimerSetRearmCallback(ID_STOPPED, onStop, ID_STOPPED);
+ gtimerSetRearmCallback(ID_LATE, onRearm, ID_LATE);
+ tick(DELAY + 1);                             /* all time-outs queued, ID_RELEASED last */
+ gtimerFreeze(ID_FROZEN);
+ gtimerFreeze(ID_FROZEN_PLAIN);
+ gtimerInitAndStart(ID_RESTARTED, RESTART, FALSE);
+ gtimerInitAndStart(ID_STOPPED, RESTART, FALSE);
+ gtimerDispatch(_N_GTIMERS);
+ nbFailed += check("callback releasing a timer with a queued time-out",
+                   Calls[ID_RELEASER] == 1 && Calls[ID_RELEASED] == 0);
+ nbFailed += check("queued time-out not given to the new owner",
+                   Calls[NEW_OWNER] == 0 && gtimerRunning(ID_RELEASED) == FALSE);
+ nbFailed += check("frozen timer called back, not rearmed",
+                   Calls[ID_FROZEN] == 1 && gtimerRunning(ID_FROZEN) == FALSE);
+ nbFailed += check("frozen timer called back (plain callback)", Calls[ID_FROZEN_PLAIN] == 1);
+ nbFailed += check("started again: called back, not rearmed",
+                   Calls[ID_RESTARTED] == 1 && gtimerGetTimeToGo(ID_RESTARTED) == RESTART);
+ nbFailed += check("started again: called back, not stopped",
+                   Calls[ID_STOPPED] == 1 && gtimerRunning(ID_STOPPED) && gtimerGetTimeToGo(ID_STOPPED) == RESTART);
+ tick(REARM - 1);
+ gtimerDispatch(_N_GTIMERS);
+ nbFailed += check("deferred rearm counted from dispatch (not yet)", Calls[ID_LATE] == 1);
+ tick(1);
+ gtimerDispatch(_N_GTIMERS);
+ nbFailed += check("deferred rearm counted from dispatch", Calls[ID_LATE] == 2);
+ return nbFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
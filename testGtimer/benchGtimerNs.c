@@ -0,0 +1,81 @@
+#define _POSIX_C_SOURCE 200112L   /* clock_gettime and CLOCK_MONOTONIC, even with -std=c99 */
+#include <stdio.h>
+#include <time.h>
+
+/**************************************************
+
+file: benchGtimerNs.c
+purpose: measures how late sub-millisecond periodic timers
+         time out with the nanosecond mode of gTimer
+         (GTIMER_IMPLEMENTS_NS, see benchGtimer.sh which
+         builds and runs it): no periodic tick, the main
+         loop only sleeps with gtimerWaitNs
+
+**************************************************/
+#include "gtimer.h"
+
+#define BENCH_DURATION_NS (1000000000UL)
+#define NB_OF_TIMERS (4)
+
+typedef struct
+{
+ dword period;       /* ns */
+ dword deadline;     /* next expected time-out, CLOCK_MONOTONIC ns */
+ dword nbOfExpiries;
+ dword sumOfLateness;
+ dword maxLateness;
+} timerDataT;
+
+static dword now(void)
+{
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return (dword)ts.tv_sec * 1000000000 + (dword)ts.tv_nsec;
+}
+
+static dword onExpiry(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ timerDataT* pData = (timerDataT*)value;
+ dword lateness = now() - pData->deadline;
+
+ pData->nbOfExpiries++;
+ pData->sumOfLateness += lateness;
+ if (lateness > pData->maxLateness)
+  {
+   pData->maxLateness = lateness;
+  }
+ pData->deadline += pData->period;   /* auto-reload keeps the phase as time-outs are processed at their deadline */
+ return 0;
+}
+
+int main(void)
+{
+ static const dword periods[NB_OF_TIMERS] = { 250000, 400000, 1000000, 3000000 };
+ timerDataT data[NB_OF_TIMERS];
+ dword start;
+ gtimerIdT id;
+
+ gtimerInitModule();
+ start = now();
+ for (id = 0; id < NB_OF_TIMERS; id++)
+  {
+   data[id].period = periods[id];
+   data[id].nbOfExpiries = data[id].sumOfLateness = data[id].maxLateness = 0;
+   gtimerReserve(id);
+   gtimerSetCallback(id, onExpiry, (dword)&data[id], NULL);
+   data[id].deadline = now() + periods[id];   /* within the time of a clock read of gTimer's own deadline */
+   gtimerInitAndStartNs(id, periods[id], TRUE);
+  }
+ while (now() - start < BENCH_DURATION_NS)
+  {
+   gtimerWaitNs(BENCH_DURATION_NS);
+  }
+ for (id = 0; id < NB_OF_TIMERS; id++)
+  {
+   printf("period %7.1f us: %6lu time-outs, lateness %7.1f us on average, %7.1f us at most\n",
+          data[id].period / 1e3, (unsigned long)data[id].nbOfExpiries,
+          data[id].nbOfExpiries ? data[id].sumOfLateness / 1e3 / data[id].nbOfExpiries : 0.0,
+          data[id].maxLateness / 1e3);
+  }
+ return 0;
+}
@@ -0,0 +1,114 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/**************************************************
+
+file: benchGtimerPools.c
+purpose: measures how gTimer pools scale across cores:
+         each thread runs its own pool of NB_OF_TIMERS
+         auto-reload timers for BENCH_DURATION_S seconds
+         (see benchGtimer.sh which builds and runs it)
+
+**************************************************/
+#include "gtimer.h"
+
+#define BENCH_DURATION_S (1.0)
+#define NB_OF_TIMERS (10000)
+#define MIN_PERIOD (100) /* periods spread between these two (ticks) */
+#define MAX_PERIOD (100000)
+#define CACHE_LINE (64)
+
+typedef struct
+{
+ dword seed;
+ dword nbOfTicks;
+ dword nbOfExpiries;
+} threadDataT;
+
+static double now(void)
+{
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static dword onExpiry(UNUSED_FCT_P gtimerIdT id, dword value)
+{
+ ((threadDataT*)value)->nbOfExpiries++;
+ return 0;
+}
+
+static void* runPool(void* arg)
+{
+ threadDataT* pData = (threadDataT*)arg;
+ gtimerPoolT* pPool;
+ void* storage;
+ double start;
+ gtimerIdT id;
+
+ /* pool and its timers are private to this thread, on their own cache lines */
+ if (posix_memalign((void**)&pPool, CACHE_LINE, sizeof(*pPool)) != 0 ||
+     posix_memalign(&storage, CACHE_LINE, GTIMER_POOL_SPACE_REQUIREMENT(NB_OF_TIMERS)) != 0 ||
+     !gtimerPoolCtor(pPool, NB_OF_TIMERS, storage))
+  {
+   return NULL;
+  }
+ for (id = 0; id < NB_OF_TIMERS; id++)
+  {
+   pData->seed = pData->seed * 1103515245 + 12345;
+   gtimerPoolReserve(pPool, id);
+   gtimerPoolSetCallback(pPool, id, onExpiry, (dword)pData, NULL);
+   gtimerPoolInitAndStart(pPool, id, MIN_PERIOD + (pData->seed >> 8) % (MAX_PERIOD - MIN_PERIOD), TRUE);
+  }
+ start = now();
+ do
+  {
+   word n;
+   for (n = 0; n < 256; n++)
+    {
+     gtimerPoolOnTick(pPool);
+    }
+   pData->nbOfTicks += n;
+  }
+ while (now() - start < BENCH_DURATION_S);
+ free(storage);
+ free(pPool);
+ return NULL;
+}
+
+int main(void)
+{
+ long nbOfCores = sysconf(_SC_NPROCESSORS_ONLN);
+ long nbOfThreads, t;
+ pthread_t threads[256];
+ threadDataT* data;
+
+ if (posix_memalign((void**)&data, CACHE_LINE, 256 * CACHE_LINE) != 0)
+  {
+   return 1;
+  }
+ printf("%ld core(s), %d timers per pool\n", nbOfCores, NB_OF_TIMERS);
+ for (nbOfThreads = 1; nbOfThreads <= 2 * nbOfCores && nbOfThreads <= 256; nbOfThreads *= 2)
+  {
+   double total = 0;
+   for (t = 0; t < nbOfThreads; t++)
+    {
+     threadDataT* pData = (threadDataT*)((char*)data + t * CACHE_LINE);
+     pData->seed = 12345 + t;
+     pData->nbOfTicks = pData->nbOfExpiries = 0;
+     pthread_create(&threads[t], NULL, runPool, pData);
+    }
+   for (t = 0; t < nbOfThreads; t++)
+    {
+     pthread_join(threads[t], NULL);
+     total += ((threadDataT*)((char*)data + t * CACHE_LINE))->nbOfTicks;
+    }
+   printf("%3ld thread(s): %12.0f ticks/s in total, %12.0f per thread\n",
+          nbOfThreads, total / BENCH_DURATION_S, total / BENCH_DURATION_S / nbOfThreads);
+  }
+ free(data);
+ return 0;
+}
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/**************************************************
+
+file: benchGtimerSlack.c
+purpose: counts how many distinct wake-up ticks NB_OF_TIMERS
+         periodic housekeeping timers need when run tickless,
+         without slack and with a slack of 1/SLACK_DIVIDER of
+         their period (GTIMER_IMPLEMENTS_SLACK, see benchGtimer.sh
+         which builds and runs it), and checks that every
+         time-out stays within the slack of its nominal
+         deadline, with no drift
+
+**************************************************/
+#include "gtimer.h"
+
+#define NB_OF_TIMERS (_N_GTIMERS)
+#define NB_OF_TICKS (10000000UL)
+#define MIN_PERIOD (1000) /* periods spread between these two (ticks) */
+#define MAX_PERIOD (10000)
+#define SLACK_DIVIDER (16)
+
+typedef struct
+{
+ dword period;
+ dword slack;
+ dword nbOfExpiries;
+ dword maxLateness;
+ boolean bOutOfWindow;
+} timerDataT;
+
+static timerDataT Data[NB_OF_TIMERS];
+static dword Now;   /* ticks applied so far */
+
+static dword onExpiry(gtimerIdT id, UNUSED_FCT_P dword value)
+{
+ timerDataT* pData = &Data[id];
+ dword lateness = Now - (pData->nbOfExpiries + 1) * pData->period;   /* from nominal deadline */
+
+ pData->nbOfExpiries++;
+ if (lateness > pData->slack)
+  {
+   pData->bOutOfWindow = TRUE;
+  }
+ if (lateness > pData->maxLateness)
+  {
+   pData->maxLateness = lateness;
+  }
+ return 0;
+}
+
+static void run(dword slackDivider)
+{
+ dword seed = 12345, wakeUps = 0, toGo, maxLateness = 0;
+ unsigned long nbOfExpiries = 0;
+ boolean bOutOfWindow = FALSE;
+ gtimerIdT id;
+
+ gtimerInitModule();
+ Now = 0;
+ for (id = 0; id < NB_OF_TIMERS; id++)
+  {
+   seed = seed * 1103515245 + 12345;
+   Data[id].period = MIN_PERIOD + (seed >> 8) % (MAX_PERIOD - MIN_PERIOD);
+   Data[id].slack = slackDivider ? Data[id].period / slackDivider : 0;
+   Data[id].nbOfExpiries = Data[id].maxLateness = 0;
+   Data[id].bOutOfWindow = FALSE;
+   gtimerReserve(id);
+   gtimerSetCallback(id, onExpiry, 0, NULL);
+   gtimerSetSlack(id, Data[id].slack);
+   gtimerInitAndStart(id, Data[id].period, TRUE);
+  }
+ while ((toGo = gtimerTicksUntilNextExpiry()) != 0 && Now + toGo <= NB_OF_TICKS)
+  {
+   Now += toGo;             /* callbacks see the tick they are called on */
+   gtimerAdvance(toGo);
+   wakeUps++;
+  }
+ for (id = 0; id < NB_OF_TIMERS; id++)
+  {
+   nbOfExpiries += Data[id].nbOfExpiries;
+   bOutOfWindow |= Data[id].bOutOfWindow;
+   if (Data[id].maxLateness > maxLateness)
+    {
+     maxLateness = Data[id].maxLateness;
+    }
+  }
+ printf("slack %s%-2lu: %7lu wake-ups for %8lu time-outs over %lu ticks, %5lu ticks late at most%s\n",
+        slackDivider ? "1/" : "  ", (unsigned long)slackDivider, (unsigned long)wakeUps, nbOfExpiries, NB_OF_TICKS,
+        (unsigned long)maxLateness, bOutOfWindow ? ", OUT OF SLACK WINDOW" : "");
+}
+
+int main(void)
+{
+ run(0);
+ run(SLACK_DIVIDER);
+ return 0;
+}
@@ -74,7 +74,7 @@ int main(void)
    byte n;
    word ch;
 
-   if (bTimerInterruptFired)    /* flag coming from timer interrupt */
+   if (gtimerPendingTicks)    /* ticks counted by timer interrupt */
     {
      gtimerOnTick();     /* manages gTimer */
     }
@@ -129,5 +129,5 @@ int main(void)
 
 void timer_tick(void)
 {
- bTimerInterruptFired = TRUE;
+ GTIMER_SIGNAL_TICK();
 }
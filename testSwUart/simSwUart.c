@@ -0,0 +1,763 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**************************************************
+
+file: simSwUart.c
+purpose: runs the swUart module in virtual time: the Tx line
+         is looped back on the Rx line and, instead of waiting
+         for real timer ticks, the clock jumps straight to the
+         next gTimer deadline (gtimerTicksUntilNextExpiry and
+         gtimerAdvance), so that long serial sessions run far
+         faster than real time and always give the same results,
+         first character by character, then with blocks queued
+         to be sent back to back (swUartSendBlock), then character
+         by character with a receiver measuring the bit width
+         itself (swUartReceiveAutobaud), then in messages which the
+         receiver delimits by the silences between them
+         (swUartReceiveSetFrames), also on a multidrop bus with
+         9-bit characters where the receiver only keeps messages
+         sent to its address (swUartReceiveSetAddress), then does
+         the same with GROUP_CHANNELS channels of
+         different configurations sharing one timer in a group,
+         and with as many lines of one configuration received by
+         a bit-sliced receiver sampling the port on each tick
+         of the group, and at last records the Tx line of each
+         configuration in 1-bit and 8-bit samples to decode them
+         as logic analyzer captures (swUartDecodeCapture)
+         (see simSwUart.sh which builds and runs it)
+         built with SWUART_IMPLEMENTS_TRACE and GTIMER_IMPLEMENTS_TRACE,
+         it stops tracing on the first wrong character and dumps
+         the trace ring to a file (see traceToJson)
+usage: simSwUart [number of characters per configuration [trace dump]]
+
+**************************************************/
+#include "gtimer.h"
+#include "swUart.h"
+#ifdef SWUART_IMPLEMENTS_TRACE
+ #include "trace.h"
+#endif
+
+#define DEFAULT_NB_OF_CHARS (200000)
+#define GROUP_CHANNELS (64)
+#define GROUP_BIT_WIDTH (8)
+#define CAPTURE_CHANNEL (5)    /* bit of 8-bit samples which holds the line, the others being noise */
+#define CAPTURE_PIECE (1000003)    /* samples added to a capture at each step when decoded piece by piece */
+#define CAPTURE_TIMING (CLOCKS_PER_SEC / 50)    /* a whole capture is decoded again and again for at least this long */
+#define FRAME_IDLE_TENTHS (35)    /* silence closing a frame, in tenths of a character, as Modbus RTU */
+#define MULTIDROP_ADDRESS (0x01)    /* of the receiver on a multidrop bus, which compares the bits of MULTIDROP_MASK: */
+#define MULTIDROP_MASK (0x03)    /* one message out of four is for it */
+
+typedef struct
+{
+ dword ticks;     /* virtual time */
+ dword hash;      /* of line transitions and received characters */
+ swUartDataStateE line;
+ swUartDataStateE lineBefore;    /* level of the line before the callbacks of this tick */
+ boolean bAutobaud;    /* receiver measuring its bit width */
+} simStateT;
+
+static simStateT Sim;
+static swUartEdgeT Edge;    /* decodes the same line from the times of its edges */
+static swUartDataStateE GroupLines[GROUP_CHANNELS];   /* Tx line of each channel looped back on its Rx */
+static swUartSliceMaskT Port = ~(swUartSliceMaskT)0;   /* the same lines, as read by a bit-sliced receiver */
+
+static void hashIn(dword value)
+{
+ Sim.hash = (Sim.hash ^ value) * 16777619;   /* FNV-1a */
+}
+
+static void setTxOutput(swUartDataStateE s)
+{
+ if (s != Sim.line)
+  {
+   hashIn(Sim.ticks);   /* when the line changes makes the waveform */
+   hashIn(s);
+   swUartEdgeOnEdge(&Edge, Sim.ticks, s);
+  }
+ Sim.line = s;
+}
+
+static void setCaptureOutput(swUartDataStateE s)
+{
+ Sim.line = s;
+}
+
+/* a receiver measuring its bit width samples the line on every tick, also on ticks where the transmitter sets it:
+   it reads the level the line had before, so that what it measures does not depend on the order of callbacks due on
+   one tick (not the same with the timing wheel) */
+static swUartDataStateE getRxInput(void)
+{
+ return Sim.bAutobaud ? Sim.lineBefore : Sim.line;
+}
+
+static void setGroupTxOutput(word channel, swUartDataStateE s)
+{
+ if (s != GroupLines[channel])
+  {
+   hashIn(Sim.ticks);
+   hashIn(channel);
+   hashIn(s);
+  }
+ GroupLines[channel] = s;
+ if (channel < SWUART_SLICE_LINES)
+  {
+   Port = (Port & ~((swUartSliceMaskT)1 << channel)) | (swUartSliceMaskT)s << channel;
+  }
+}
+
+
+static swUartDataStateE getGroupRxInput(word channel)
+{
+ return GroupLines[channel];
+}
+
+/* bit width of a configuration, as printed */
+static const char* widthOf(const swUartConfigurationT* pCfg)
+{
+ static char width[16];
+
+ if (pCfg->bitWidthFraction != 0)
+  {
+   sprintf(width, "%2u+%u/256", pCfg->bitWidth, pCfg->bitWidthFraction);
+  }
+ else
+  {
+   sprintf(width, "%2u", pCfg->bitWidth);
+  }
+ return width;
+}
+
+/* configuration, as printed */
+static const char* configurationOf(const swUartConfigurationT* pCfg)
+{
+ static char configuration[80];
+ char scan[24] = "";
+
+ if (pCfg->oversampling != 0)
+  {
+   sprintf(scan, ", %ux oversampling", pCfg->oversampling);
+  }
+ sprintf(configuration, "%2u bits, %s parity, %u stop, width %s%s", pCfg->nbBits,
+         pCfg->parity == swUNoParity ? "no  " : pCfg->parity == swUEvenParity ? "even" : "odd ",
+         pCfg->stop == swU2Stop ? 2 : 1, widthOf(pCfg), pCfg->oversampling != 0 ? scan : pCfg->bTripleScan ? ", triple scan" : "");
+ return configuration;
+}
+
+/* runs one configuration, sending and receiving characters one by one or, if bQueued, sending them in two blocks
+   of half of what is expected queued in turn and receiving them in bulk from a FIFO of the application: returns
+   number of characters received wrong or missing, by the receiver or by an edge receiver on the same line
+   if bAutobaud, the receiver first measures the bit width on a few 'U' */
+static unsigned long simulate(const swUartConfigurationT* pCfg, unsigned long nbOfChars, unsigned long long* pNbOfBits,
+                              boolean bQueued, boolean bAutobaud)
+{
+ const word mask = (word)((1 << pCfg->nbBits) - 1);
+ const unsigned bitsPerChar = 1 + pCfg->nbBits + (pCfg->parity != swUNoParity) + (pCfg->stop == swU2Stop ? 2 : 1);
+ /* characters sent and not received yet beyond which nothing more can be sent */
+ const unsigned long window = bQueued ? 33 : 64;
+ dword seed = 1;
+ word expected[64];
+ byte bytes[64];    /* the same when they fit in bytes, to be sent from blocks */
+ swUartTxBlockT blocks[2] = { { bytes, 0, 0, NULL }, { bytes, 0, 0, NULL } };
+ RCPT_FIFO_TYPE fifo[32], received[64];
+ swUartConfigurationT edgeCfg = *pCfg, rxCfg = *pCfg;
+ unsigned long nbSent = 0, nbReceived = 0, nbWrong = 0, nbEdgeReceived = 0, nbEdgeWrong = 0;
+ dword toGo, nbRead, r;
+ word ch, n, b;
+
+ Sim.ticks = 0;
+ Sim.hash = 2166136261u;
+ Sim.line = swUMark_High;
+ gtimerInitModule();
+ gtimerReserve(SWUART1_SEND_TIMER_ID);
+ gtimerReserve(SWUART1_RECEIVE_TIMER_ID);
+ if (!swUartSendInit(0, pCfg, SWUART1_SEND_TIMER_ID, setTxOutput) ||
+     !(bAutobaud ? swUartReceiveAutobaud(0, &rxCfg, SWUART1_RECEIVE_TIMER_ID, getRxInput, 10) :
+                   swUartReceiveInit(0, pCfg, SWUART1_RECEIVE_TIMER_ID, getRxInput)))
+  {
+   printf("configuration rejected\n");
+   return nbOfChars;
+  }
+ edgeCfg.bTripleScan = FALSE;
+ edgeCfg.oversampling = 0;
+ if (!swUartEdgeCtor(&Edge, &edgeCfg))
+  {
+   printf("configuration rejected by edge receiver\n");
+   return nbOfChars;
+  }
+ Sim.bAutobaud = bAutobaud;
+ for (n = 0; bAutobaud && Sim.ticks < 64 * 14 * (dword)pCfg->bitWidth; )    /* gives up after 64 characters */
+  {
+   if (n < 4 && !swUartSendIsBusy(0))
+    {
+     swUartSendChar(0, 0x155 & mask);    /* single-bit pulses */
+     n++;
+    }
+   toGo = gtimerTicksUntilNextExpiry();
+   if (toGo == 0)    /* characters sent and receiver timer stopped: measure over */
+    {
+     swUartEdgeOnTime(&Edge, Sim.ticks);
+     swUartEdgeFlushChars(&Edge);    /* 'U' were not expected */
+     break;
+    }
+   Sim.ticks += toGo;
+   Sim.lineBefore = Sim.line;
+   gtimerAdvance(toGo);
+  }
+ Sim.bAutobaud = FALSE;
+ /* measured from whole ticks: should be within 1/32 of a bit */
+ if (labs((long)(rxCfg.bitWidth * 256 + rxCfg.bitWidthFraction) - (long)(pCfg->bitWidth * 256 + pCfg->bitWidthFraction)) * 32 >
+     pCfg->bitWidth * 256 + pCfg->bitWidthFraction)
+  {
+   printf("bit width measured %s\n", widthOf(&rxCfg));
+   return nbOfChars;
+  }
+ if (bQueued && !swUartReceiveSetFifo(0, fifo, sizeof(fifo) / sizeof(*fifo)))
+  {
+   printf("FIFO rejected\n");
+   return nbOfChars;
+  }
+ while (nbReceived < nbOfChars)
+  {
+   b = (word)(nbSent / 32 % 2);
+   if (bQueued && nbSent < nbOfChars && blocks[b].index == blocks[b].size && nbSent - nbReceived <= 32)
+    {
+     /* refills this half once its block is out and received: the other one keeps the transmitter busy */
+     n = nbOfChars - nbSent < 32 ? (word)(nbOfChars - nbSent) : 32;
+     for (ch = 0; ch < n; ch++)
+      {
+       seed = seed * 1103515245 + 12345;
+       bytes[32 * b + ch] = (byte)(expected[32 * b + ch] = (word)(seed >> 16) & mask);
+      }
+     blocks[b].data = pCfg->nbBits > 8 ? (const void*)&expected[32 * b] : &bytes[32 * b];
+     blocks[b].size = n;
+     blocks[b].index = 0;
+     swUartSendBlock(0, &blocks[b]);
+     nbSent += n;
+    }
+   else if (!bQueued && nbSent < nbOfChars && !swUartSendIsBusy(0) && nbSent - nbReceived < window)
+    {
+     seed = seed * 1103515245 + 12345;
+     expected[nbSent % (sizeof(expected) / sizeof(*expected))] = (word)(seed >> 16) & mask;
+     swUartSendChar(0, expected[nbSent % (sizeof(expected) / sizeof(*expected))]);
+     nbSent++;
+    }
+   swUartReceiveScanForStart(0);    /* line only changes on deadlines: polled as often as it can */
+   nbRead = 0;
+   if (bQueued)
+    {
+     nbRead = swUartReadBuffer(0, received, sizeof(received) / sizeof(*received));
+    }
+   while (!bQueued && nbRead < sizeof(received) / sizeof(*received) && (ch = swUartGetChar(0)) != 0xffff)
+    {
+     received[nbRead++] = ch;
+    }
+   for (r = 0; r < nbRead; r++)
+    {
+     ch = received[r];
+     hashIn(ch);
+     if (nbReceived < nbSent && ch != expected[nbReceived % (sizeof(expected) / sizeof(*expected))])
+      {
+       nbWrong++;
+#ifdef SWUART_IMPLEMENTS_TRACE
+       traceSetRecording(FALSE);    /* keeps what led to it */
+#endif
+      }
+     nbReceived++;
+    }
+   swUartEdgeOnTime(&Edge, Sim.ticks);    /* gets characters as soon as the receiver */
+   nbRead = swUartEdgeReadBuffer(&Edge, received, sizeof(received) / sizeof(*received));
+   for (r = 0; r < nbRead; r++)
+    {
+     if (nbEdgeReceived >= nbSent || received[r] != expected[nbEdgeReceived % (sizeof(expected) / sizeof(*expected))])
+      {
+       nbEdgeWrong++;
+      }
+     nbEdgeReceived++;
+    }
+   toGo = gtimerTicksUntilNextExpiry();
+   if (toGo == 0)
+    {
+     if (nbSent == nbOfChars || nbSent - nbReceived >= window)
+      {
+       break;       /* nothing will ever happen again: characters were lost */
+      }
+     continue;
+    }
+   Sim.ticks += toGo;    /* straight to next deadline */
+   gtimerAdvance(toGo);
+  }
+ *pNbOfBits += (unsigned long long)nbSent * bitsPerChar;
+ printf("%s%s: %7lu chars, %7lu received, %lu wrong, errors 0x%02x, %9lu ticks, hash %08lx, edge receiver %lu wrong\n",
+        configurationOf(pCfg), bQueued ? ", queued" : bAutobaud ? ", autobaud" : "",
+        nbSent, nbReceived, nbWrong, (unsigned)swUartReceiveGetAndClearError(0, TRUE),
+        (unsigned long)Sim.ticks, (unsigned long)(Sim.hash & 0xffffffff),
+        nbEdgeWrong + (nbReceived - nbEdgeReceived) + swUartEdgeGetAndClearError(&Edge, TRUE));
+ return nbWrong + (nbOfChars - nbReceived) + nbEdgeWrong + (nbReceived - nbEdgeReceived) +
+        swUartEdgeGetAndClearError(&Edge, TRUE);
+}
+
+/* advances virtual time as long as the transmitter is busy, then for a silence of the line of a number of ticks,
+   looking for start bits all along */
+static void sendAndWait(dword silence)
+{
+ dword end = 0, toGo;
+
+ for (;;)
+  {
+   swUartReceiveScanForStart(0);
+   if (end == 0 && !swUartSendIsBusy(0))
+    {
+     end = Sim.ticks + silence;
+    }
+   if (end != 0 && Sim.ticks >= end)
+    {
+     return;
+    }
+   toGo = gtimerTicksUntilNextExpiry();
+   if (end != 0 && (toGo == 0 || toGo > end - Sim.ticks))
+    {
+     toGo = end - Sim.ticks;
+    }
+   Sim.ticks += toGo;
+   gtimerAdvance(toGo);
+  }
+}
+
+/* runs one configuration in messages of 1 to 32 characters queued as blocks, separated by silences of 1 character,
+   which do not end a frame, or of 6, which do: with parity, one message out of 16 is sent with the wrong one, its
+   characters being left out of their frame, which reports parity errors. If bMultidrop, each message begins with an
+   address and the receiver only keeps those sent to it, with no frame for the others. Returns number of characters
+   and frames received wrong or missing */
+static unsigned long simulateFrames(const swUartConfigurationT* pCfg, unsigned long nbOfChars,
+                                    unsigned long long* pNbOfBits, boolean bMultidrop)
+{
+ const word mask = (word)((1 << pCfg->nbBits) - 1);
+ const word addressBit = (word)(1 << (pCfg->nbBits - 1));
+ const unsigned bitsPerChar = 1 + pCfg->nbBits + (pCfg->parity != swUNoParity) + (pCfg->stop == swU2Stop ? 2 : 1);
+ swUartConfigurationT wrongParity = *pCfg;
+ word expected[128];    /* characters of the frame going on */
+ byte bytes[32];
+ swUartTxBlockT block = { NULL, 0, 0, NULL };
+ RCPT_FIFO_TYPE fifo[256], received[128];
+ swUartFrameT frames[4], frame;
+ unsigned long nbSent = 0, nbStored = 0, nbOfFrames = 0, nbWrong = 0, nbOfMessages = 0;
+ dword seed = 1, length = 0, first = 0;
+ byte errors = 0, n, i;
+ boolean bWrongParity;
+ word ch;
+
+ Sim.ticks = 0;
+ Sim.hash = 2166136261u;
+ Sim.line = swUMark_High;
+ wrongParity.parity = pCfg->parity == swUEvenParity ? swUOddParity : swUEvenParity;
+ gtimerInitModule();
+ gtimerReserve(SWUART1_SEND_TIMER_ID);
+ gtimerReserve(SWUART1_RECEIVE_TIMER_ID);
+ if (!swUartSendInit(0, pCfg, SWUART1_SEND_TIMER_ID, setCaptureOutput) ||
+     !swUartReceiveInit(0, pCfg, SWUART1_RECEIVE_TIMER_ID, getRxInput) ||
+     !swUartReceiveSetFifo(0, fifo, sizeof(fifo) / sizeof(*fifo)) ||
+     !swUartReceiveSetFrames(0, frames, sizeof(frames) / sizeof(*frames), FRAME_IDLE_TENTHS) ||
+     !swUartReceiveSetAddress(0, bMultidrop, MULTIDROP_ADDRESS, MULTIDROP_MASK))
+  {
+   printf("configuration rejected\n");
+   return nbOfChars;
+  }
+ while (nbSent < nbOfChars)
+  {
+   seed = seed * 1103515245 + 12345;
+   n = (byte)(seed >> 16 & 31) + 1;
+   bWrongParity = pCfg->parity != swUNoParity && nbOfMessages++ % 16 == 15;
+   for (i = 0; i < n; i++)
+    {
+     seed = seed * 1103515245 + 12345;
+     ch = (word)(seed >> 16) & mask;
+     if (bMultidrop)
+      {
+       ch = i == 0 ? ch | addressBit : ch & ~addressBit;    /* an address, then data */
+      }
+     bytes[i] = (byte)(expected[length + i] = ch);
+    }
+   block.data = pCfg->nbBits > 8 ? (const void*)&expected[length] : bytes;
+   if (bWrongParity)
+    {
+     errors |= 1 << swUParityError;    /* and the receiver is not selected any more */
+    }
+   else if (!bMultidrop || (expected[length] & MULTIDROP_MASK) == MULTIDROP_ADDRESS)
+    {
+     length += n;
+    }
+   block.size = n;
+   block.index = 0;
+   swUartSendInit(0, bWrongParity ? &wrongParity : pCfg, SWUART1_SEND_TIMER_ID, setCaptureOutput);
+   swUartSendBlock(0, &block);
+   nbSent += n;
+   seed = seed * 1103515245 + 12345;
+   if (length <= sizeof(expected) / sizeof(*expected) - 32 && (seed >> 16 & 3) == 0)
+    {
+     sendAndWait((dword)bitsPerChar * pCfg->bitWidth);    /* same frame goes on */
+     if (swUartHowManyFrames(0) != 0)
+      {
+       nbWrong++;
+      }
+     continue;
+    }
+   sendAndWait(6 * (dword)bitsPerChar * pCfg->bitWidth);
+   if (length == 0 && errors == 0)    /* messages to other nodes only */
+    {
+     if (swUartHowManyFrames(0) != 0 || swUartHowManyChars(0) != 0)
+      {
+       nbWrong++;
+      }
+     continue;
+    }
+   if (!swUartGetFrame(0, &frame) || frame.start != first || frame.length != length || frame.errors != errors ||
+       swUartHowManyFrames(0) != 0 || swUartReadBuffer(0, received, sizeof(received) / sizeof(*received)) != length)
+    {
+     nbWrong++;
+    }
+   for (i = 0; i < length; i++)
+    {
+     hashIn(received[i]);
+     if (received[i] != expected[i])
+      {
+       nbWrong++;
+      }
+    }
+   hashIn(Sim.ticks);
+   hashIn(length);
+   nbOfFrames++;
+   nbStored += length;
+   first += length;
+   length = 0;
+   errors = 0;
+  }
+ *pNbOfBits += (unsigned long long)nbSent * bitsPerChar;
+ printf("%s, %s: %7lu chars, %7lu stored, %6lu frames, %lu wrong, errors 0x%02x, %9lu ticks, hash %08lx\n",
+        configurationOf(pCfg), bMultidrop ? "multidrop frames" : "frames", nbSent, nbStored, nbOfFrames, nbWrong, (unsigned)swUartReceiveGetAndClearError(0, TRUE),
+        (unsigned long)Sim.ticks, (unsigned long)(Sim.hash & 0xffffffff));
+ return nbWrong;
+}
+
+/* runs all configurations at once in a group, received by the group itself or by a bit-sliced receiver (then
+   with the first configuration only): returns number of characters received wrong or missing */
+static unsigned long simulateGroup(const swUartConfigurationT* configurations, unsigned nbOfConfigurations,
+                                   unsigned long nbOfChars, unsigned long long* pNbOfBits, boolean bSliced)
+{
+ static swUartTxChannelT txChannels[GROUP_CHANNELS];
+ static swUartRxChannelT rxChannels[GROUP_CHANNELS];
+ static swUartSliceLineT lines[GROUP_CHANNELS];
+ const word nbOfChannels = bSliced && SWUART_SLICE_LINES < GROUP_CHANNELS ? SWUART_SLICE_LINES : GROUP_CHANNELS;
+ swUartSliceT slice;
+ static word expected[GROUP_CHANNELS][16];
+ static unsigned long nbSent[GROUP_CHANNELS], nbReceived[GROUP_CHANNELS];
+ swUartGroupT group;
+ dword seed = 1;
+ unsigned long nbWrong = 0, nbDone = 0, nbOfBits = 0;
+ byte errors = 0;
+ word i, ch;
+ dword toGo;
+
+ Sim.ticks = 0;
+ Sim.hash = 2166136261u;
+ gtimerInitModule();
+ gtimerReserve(SWUART1_SEND_TIMER_ID);
+ if (bSliced)
+  {
+   nbOfConfigurations = 1;
+  }
+ if (!swUartGroupCtor(&group, GROUP_BIT_WIDTH, SWUART1_SEND_TIMER_ID, txChannels, nbOfChannels, setGroupTxOutput,
+                      rxChannels, bSliced ? 0 : nbOfChannels, getGroupRxInput) ||
+     (bSliced && !swUartSliceCtor(&slice, configurations, lines, (byte)nbOfChannels, 0, NULL)))
+  {
+   printf("group rejected\n");
+   return nbOfChars;
+  }
+ for (i = 0; i < nbOfChannels; i++)
+  {
+   const swUartConfigurationT* pCfg = &configurations[i % nbOfConfigurations];
+
+   nbSent[i] = nbReceived[i] = 0;
+   GroupLines[i] = swUMark_High;
+   if (!swUartGroupSendInit(&group, i, pCfg) || (!bSliced && !swUartGroupReceiveInit(&group, i, pCfg)))
+    {
+     printf("configuration rejected in group\n");
+     return nbOfChars;
+    }
+   nbOfBits += 1 + pCfg->nbBits + (pCfg->parity != swUNoParity) + (pCfg->stop == swU2Stop ? 2 : 1);
+  }
+ while (nbDone < nbOfChannels)
+  {
+   for (i = 0; i < nbOfChannels; i++)
+    {
+     if (nbSent[i] < nbOfChars && !swUartGroupSendIsBusy(&group, i) && nbSent[i] - nbReceived[i] < 16)
+      {
+       seed = seed * 1103515245 + 12345;
+       expected[i][nbSent[i] % 16] = (word)(seed >> 16) & ((1 << configurations[i % nbOfConfigurations].nbBits) - 1);
+       swUartGroupSendChar(&group, i, expected[i][nbSent[i]++ % 16]);
+      }
+     else if (swUartGroupSendIsBusy(&group, i) && swUartGroupSendChar(&group, i, 0))
+      {
+       nbWrong++;    /* refused, without changing what is on the line: the hash says so */
+      }
+     while ((ch = bSliced ? swUartSliceGetChar(&slice, (byte)i) : swUartGroupGetChar(&group, i)) != 0xffff)
+      {
+       hashIn(ch);
+       if (nbReceived[i] < nbSent[i] && ch != expected[i][nbReceived[i] % 16])
+        {
+         nbWrong++;
+        }
+       if (++nbReceived[i] == nbOfChars)
+        {
+         nbDone++;
+        }
+      }
+    }
+   toGo = gtimerTicksUntilNextExpiry();   /* next tick of the group */
+   Sim.ticks += toGo;
+   gtimerAdvance(toGo);
+   if (bSliced)
+    {
+     swUartSliceOnSample(&slice, Port);   /* port sampled right after the group sets its lines */
+    }
+   if (Sim.ticks / GROUP_BIT_WIDTH > 16 * nbOfChars)
+    {
+     break;       /* characters were lost */
+    }
+  }
+ for (i = 0; i < nbOfChannels; i++)
+  {
+   errors |= bSliced ? swUartSliceGetAndClearError(&slice, (byte)i, TRUE) : swUartGroupReceiveGetAndClearError(&group, i, TRUE);
+   nbWrong += nbOfChars - nbReceived[i];
+  }
+ *pNbOfBits += (unsigned long long)nbOfBits * nbOfChars;
+ printf("%s of %u channels, width %2u: %7lu chars each, %lu wrong or missing, errors 0x%02x, %9lu ticks, hash %08lx\n",
+        bSliced ? "bit-sliced" : "group", nbOfChannels, GROUP_BIT_WIDTH, nbOfChars, nbWrong, (unsigned)errors,
+        (unsigned long)Sim.ticks, (unsigned long)(Sim.hash & 0xffffffff));
+ return nbWrong;
+}
+
+/* records n samples of the Tx line from Sim.ticks on, in 1-bit and in 8-bit samples */
+static void record(byte* bits, byte* bytes, dword n, dword* pSeed)
+{
+ dword i;
+
+ for (i = Sim.ticks; i < Sim.ticks + n; i++)
+  {
+   *pSeed = *pSeed * 1103515245 + 12345;
+   bits[i >> 3] |= (byte)(Sim.line << (i & 7));
+   bytes[i] = (byte)((*pSeed >> 16 & ~(1 << CAPTURE_CHANNEL)) | Sim.line << CAPTURE_CHANNEL);
+  }
+}
+
+/* if two configurations make the same captures and decode them the same way: scanning options are not used */
+static boolean sameCapture(const swUartConfigurationT* pCfg, const swUartConfigurationT* pOther)
+{
+ return pCfg->bitWidth == pOther->bitWidth && pCfg->bitWidthFraction == pOther->bitWidthFraction &&
+        pCfg->stop == pOther->stop && pCfg->parity == pOther->parity && pCfg->nbBits == pOther->nbBits;
+}
+
+/* records the Tx line of one configuration, one sample per tick, with characters sent now and then after idle
+   times, and decodes the capture from 1-bit then 8-bit samples, piece by piece, then all at once (over and over
+   to time it), and with the opposite parity: returns number of characters decoded wrong or missing */
+static unsigned long decodeCapture(const swUartConfigurationT* pCfg, unsigned long nbOfChars,
+                                   unsigned long long* pNbOfBytes, double* pElapsed)
+{
+ const word mask = (word)((1 << pCfg->nbBits) - 1);
+ const dword maxSamples = (dword)nbOfChars * 18 * pCfg->bitWidth + pCfg->bitWidth;
+ byte* bits = calloc(maxSamples / 8 + 1, 1);
+ byte* bytes = malloc(maxSamples);
+ word* expected = malloc(nbOfChars * sizeof(*expected));
+ swUartDecodedCharT* decoded = malloc(nbOfChars * sizeof(*decoded));
+ swUartConfigurationT otherParity = *pCfg;
+ swUartCaptureT capture;
+ unsigned long nbSent = 0, nbWrong[2] = { 0, 0 };
+ dword seed = 1, noise = 1, position, toGo, n, got, i;
+ clock_t start;
+ byte f;
+
+ Sim.ticks = 0;
+ Sim.line = swUMark_High;
+ gtimerInitModule();
+ gtimerReserve(SWUART1_SEND_TIMER_ID);
+ if (bits == NULL || bytes == NULL || expected == NULL || decoded == NULL ||
+     !swUartSendInit(0, pCfg, SWUART1_SEND_TIMER_ID, setCaptureOutput))
+  {
+   printf("capture not made\n");
+   free(bits), free(bytes), free(expected), free(decoded);
+   return nbOfChars;
+  }
+ for (;;)
+  {
+   if (!swUartSendIsBusy(0))
+    {
+     if (nbSent == nbOfChars)
+      {
+       break;
+      }
+     seed = seed * 1103515245 + 12345;
+     toGo = (seed >> 28 & 1) ? (seed >> 24 & 3) * pCfg->bitWidth + (seed >> 20 & 7) : 0;    /* idle line */
+     record(bits, bytes, toGo, &noise);
+     Sim.ticks += toGo;
+     expected[nbSent] = (word)(seed >> 8) & mask;
+     swUartSendChar(0, expected[nbSent++]);
+    }
+   toGo = gtimerTicksUntilNextExpiry();
+   record(bits, bytes, toGo, &noise);
+   Sim.ticks += toGo;
+   gtimerAdvance(toGo);
+  }
+ record(bits, bytes, pCfg->bitWidth, &noise);
+ Sim.ticks += pCfg->bitWidth;
+ for (f = 0; f < 2; f++)
+  {
+   capture.samples = f == 0 ? bits : bytes;
+   capture.bitsPerSample = f == 0 ? 1 : 8;
+   capture.channel = CAPTURE_CHANNEL;
+   capture.nbOfSamples = 0;
+   position = n = 0;
+   do
+    {
+     /* as from a file read or mapped piece by piece */
+     capture.nbOfSamples = Sim.ticks - capture.nbOfSamples > CAPTURE_PIECE ? capture.nbOfSamples + CAPTURE_PIECE : Sim.ticks;
+     while ((got = swUartDecodeCapture(pCfg, &capture, &position, decoded + n, nbOfChars - n < 1000 ? nbOfChars - n : 1000)) != 0)
+      {
+       n += got;
+      }
+    }
+   while (capture.nbOfSamples < Sim.ticks);
+   for (i = 0; i < n; i++)
+    {
+     nbWrong[f] += decoded[i].ch != expected[i] || decoded[i].errors != 0;
+    }
+   nbWrong[f] += nbOfChars - n;
+   start = clock();
+   do
+    {
+     position = 0;
+     got = swUartDecodeCapture(pCfg, &capture, &position, decoded, nbOfChars);
+     *pNbOfBytes += f == 0 ? (Sim.ticks + 7) / 8 : Sim.ticks;
+    }
+   while (clock() - start < CAPTURE_TIMING);
+   *pElapsed += (double)(clock() - start) / CLOCKS_PER_SEC;
+   nbWrong[f] += got != nbOfChars;
+   if (pCfg->parity != swUNoParity)
+    {
+     otherParity.parity = pCfg->parity == swUEvenParity ? swUOddParity : swUEvenParity;
+     position = 0;
+     n = swUartDecodeCapture(&otherParity, &capture, &position, decoded, nbOfChars);
+     for (i = 0; i < n; i++)
+      {
+       nbWrong[f] += decoded[i].errors != 1 << swUParityError;
+      }
+    }
+  }
+ printf("capture of %2u bits, %s parity, %u stop, width %s: %7lu chars, %9lu samples, %lu wrong from 1-bit samples, "
+        "%lu wrong from 8-bit samples\n",
+        pCfg->nbBits, pCfg->parity == swUNoParity ? "no  " : pCfg->parity == swUEvenParity ? "even" : "odd ",
+        pCfg->stop == swU2Stop ? 2 : 1, widthOf(pCfg), nbOfChars, (unsigned long)Sim.ticks, nbWrong[0], nbWrong[1]);
+ free(bits), free(bytes), free(expected), free(decoded);
+ return nbWrong[0] + nbWrong[1];
+}
+
+int main(int argc, char** argv)
+{
+ static const swUartConfigurationT configurations[] =
+  {
+   { 4, swU1Stop, swUNoParity, 8, FALSE, 0, 0, 0 },
+   { 4, swU2Stop, swUEvenParity, 8, FALSE, 0, 0, 0 },
+   { 8, swU1Stop, swUOddParity, 7, FALSE, 0, 0, 0 },
+   { 8, swU1Stop, swUEvenParity, 9, FALSE, 0, 0, 0 },
+   { 16, swU2Stop, swUNoParity, 5, FALSE, 0, 0, 0 },
+   { 8, swU1Stop, swUNoParity, 8, TRUE, 0, 0, 0 },
+   { 16, swU1Stop, swUEvenParity, 8, TRUE, 0, 0, 0 },
+   { 16, swU1Stop, swUEvenParity, 8, FALSE, 4, 3, 0 },
+   { 16, swU1Stop, swUOddParity, 7, FALSE, 8, 5, 0 },
+   { 32, swU2Stop, swUNoParity, 9, FALSE, 16, 3, 0 },
+   { 5, swU1Stop, swUNoParity, 8, FALSE, 0, 0, 53 },    /* 9600 bit/s from a 50 kHz tick */
+   { 8, swU1Stop, swUEvenParity, 8, FALSE, 4, 3, 174 },    /* 115200 bit/s from a 1 MHz tick */
+   { 34, swU2Stop, swUOddParity, 7, FALSE, 16, 5, 184 },    /* 28800 bit/s from a 1 MHz tick */
+  };
+ static const swUartConfigurationT groupConfigurations[] =
+  {
+   { GROUP_BIT_WIDTH, swU1Stop, swUNoParity, 8, FALSE, 0, 0, 0 },
+   { GROUP_BIT_WIDTH, swU2Stop, swUEvenParity, 8, FALSE, 0, 0, 0 },
+   { GROUP_BIT_WIDTH, swU1Stop, swUOddParity, 7, FALSE, 0, 0, 0 },
+   { GROUP_BIT_WIDTH, swU1Stop, swUEvenParity, 9, FALSE, 0, 0, 0 },
+   { GROUP_BIT_WIDTH, swU2Stop, swUNoParity, 5, FALSE, 0, 0, 0 },
+  };
+ unsigned long nbOfChars = argc > 1 ? strtoul(argv[1], NULL, 0) : DEFAULT_NB_OF_CHARS;
+ unsigned long nbOfFailures = 0;
+ unsigned long long nbOfBits = 0, nbOfBytes = 0;
+ clock_t start = clock();
+ double elapsed;
+ unsigned i, j;
+
+#ifdef SWUART_IMPLEMENTS_TRACE
+ traceInit();
+#endif
+ for (i = 0; i < 3 * sizeof(configurations) / sizeof(*configurations); i++)
+  {
+   nbOfFailures += simulate(&configurations[i % (sizeof(configurations) / sizeof(*configurations))], nbOfChars,
+                            &nbOfBits, i / (sizeof(configurations) / sizeof(*configurations)) == 1,
+                            i / (sizeof(configurations) / sizeof(*configurations)) == 2);
+  }
+ elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+ printf("%llu bits simulated in %.2f s (%.0f bits/s), %s\n", nbOfBits, elapsed,
+        elapsed > 0 ? nbOfBits / elapsed : 0.0, nbOfFailures ? "FAILED" : "passed");
+ start = clock();
+ nbOfBits = 0;
+ for (i = 0; i < sizeof(configurations) / sizeof(*configurations); i++)
+  {
+   nbOfFailures += simulateFrames(&configurations[i], nbOfChars / 10, &nbOfBits, FALSE);
+  }
+ for (i = 0; i < sizeof(configurations) / sizeof(*configurations); i++)
+  {
+   if (configurations[i].nbBits == 9)
+    {
+     nbOfFailures += simulateFrames(&configurations[i], nbOfChars / 10, &nbOfBits, TRUE);
+    }
+  }
+ elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+ printf("%llu bits simulated in %.2f s (%.0f bits/s), %s\n", nbOfBits, elapsed,
+        elapsed > 0 ? nbOfBits / elapsed : 0.0, nbOfFailures ? "FAILED" : "passed");
+ for (i = 0; i < 2; i++)
+  {
+   start = clock();
+   nbOfBits = 0;
+   nbOfFailures += simulateGroup(groupConfigurations + i, sizeof(groupConfigurations) / sizeof(*groupConfigurations) - i,
+                                 nbOfChars / 16, &nbOfBits, i == 1);
+   elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+   printf("%llu bits simulated in %.2f s (%.0f bits/s), %s\n", nbOfBits, elapsed,
+          elapsed > 0 ? nbOfBits / elapsed : 0.0, nbOfFailures ? "FAILED" : "passed");
+  }
+ elapsed = 0;
+ for (i = 0; i < sizeof(configurations) / sizeof(*configurations); i++)
+  {
+   for (j = 0; j < i && !sameCapture(&configurations[i], &configurations[j]); j++)
+    {
+    }
+   if (j == i)    /* scanning options aside, not decoded yet */
+    {
+     nbOfFailures += decodeCapture(&configurations[i], nbOfChars / 10, &nbOfBytes, &elapsed);
+    }
+  }
+ printf("%llu bytes of samples decoded in %.2f s (%.0f MB/s), %s\n", nbOfBytes, elapsed,
+        elapsed > 0 ? nbOfBytes / elapsed / 1e6 : 0.0, nbOfFailures ? "FAILED" : "passed");
+#ifdef SWUART_IMPLEMENTS_TRACE
+ if (argc > 2)
+  {
+   static traceRecordT records[TRACE_RING_SIZE];
+   FILE* pFile = fopen(argv[2], "wb");
+   dword n = traceRead(records, TRACE_RING_SIZE);
+
+   if (pFile == NULL || fwrite(records, sizeof(*records), n, pFile) != n || fclose(pFile) != 0)
+    {
+     perror(argv[2]);
+     return 1;
+    }
+  }
+#endif
+ return nbOfFailures ? 1 : 0;
+}
@@ -0,0 +1,31 @@
+#!/bin/bash
+# builds and runs simSwUart.c, the virtual time simulation of swUart looped back on itself,
+# with the linear scan of gtimerOnTick and with the timing wheel: both should print the same lines,
+# then with tracing on, to show it costs little, and converts the trace of the last characters to
+# JSON (to be opened in chrome://tracing or ui.perfetto.dev), by default in ${TMPDIR}/simSwUart.json
+# usage: simSwUart.sh [number of characters per configuration [JSON trace file]]
+
+CC="gcc"
+CFLAGS="-O2 -Wall -Wextra -I.."
+SRC_DIR="$(dirname "$0")"
+BIN="${TMPDIR:-/tmp}/simSwUart.$$"
+CHARS="${1:-200000}"
+JSON="${2:-${TMPDIR:-/tmp}/simSwUart.json}"
+case "${JSON}" in
+ /*) ;;
+ *) JSON="${PWD}/${JSON}" ;;
+esac
+
+cd "${SRC_DIR}" || exit 1
+for ENGINE in "" "-DGTIMER_IMPLEMENTS_WHEEL"
+do
+ ${CC} ${CFLAGS} ${ENGINE} ../gtimer.c ../swUart.c simSwUart.c -o "${BIN}" || exit 1
+ "${BIN}" "${CHARS}" || { rm -f "${BIN}"; exit 1; }
+done
+
+TRACE="-DSWUART_IMPLEMENTS_TRACE -DGTIMER_IMPLEMENTS_TRACE -DTRACE_RING_SIZE=4096"
+${CC} ${CFLAGS} ${TRACE} ../gtimer.c ../swUart.c ../trace.c simSwUart.c -o "${BIN}" || exit 1
+"${BIN}" "${CHARS}" "${BIN}.dump" || { rm -f "${BIN}" "${BIN}.dump"; exit 1; }
+${CC} ${CFLAGS} ../traceToJson/traceToJson.c -o "${BIN}" || { rm -f "${BIN}.dump"; exit 1; }
+"${BIN}" "${BIN}.dump" "${JSON}"
+rm -f "${BIN}" "${BIN}.dump"
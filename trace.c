@@ -0,0 +1,208 @@
+/*
+
+File name: trace.c
+Target: portable
+Purpose: Event trace ring
+
+*/
+
+/****************************************************************************/
+/*                                                                          */
+/*                  MODULE DEPENDENCY                                       */
+/*                                                                          */
+/****************************************************************************/
+
+#include "trace.h"
+
+/****************************************************************************/
+/*                                                                          */
+/*                  DEFINITIONS AND MACROS                                  */
+/*                                                                          */
+/****************************************************************************/
+
+#define RING_MASK (TRACE_RING_SIZE - 1)
+#define SLOT_WORDS (sizeof(traceRecordT) / sizeof(slotWordT))
+
+/* accesses shared by the contexts which record and read events at the same time */
+#ifdef __GNUC__
+ #define FETCH_AND_INC(p) __atomic_fetch_add(p, 1, __ATOMIC_RELAXED)
+ #define LOAD(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+ #define STORE(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+ #define LOAD_RELAXED(p) __atomic_load_n(p, __ATOMIC_RELAXED)
+ #define STORE_RELAXED(p, v) __atomic_store_n(p, v, __ATOMIC_RELAXED)
+ #define FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+ #define FENCE_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#else
+ #ifndef TRACE_ENTER_CRITICAL /* should mask interrupts which record events */
+  #define TRACE_ENTER_CRITICAL()
+  #define TRACE_EXIT_CRITICAL()
+ #endif
+ #define FETCH_AND_INC(p) fetch_AndInc(p)
+ #define LOAD(p) (*(p))
+ #define STORE(p, v) (*(p) = (v))
+ #define LOAD_RELAXED(p) (*(p))
+ #define STORE_RELAXED(p, v) (*(p) = (v))
+ #define FENCE_ACQUIRE()
+ #define FENCE_RELEASE()
+#endif
+
+/* a record is stored and loaded as whole machine words: one on 64-bit targets */
+#if defined(__GNUC__) && __SIZEOF_POINTER__ >= 8
+typedef unsigned long long slotWordT;
+#elif defined(__GNUC__)
+typedef unsigned int slotWordT;
+#else
+typedef dword slotWordT;
+#endif
+
+typedef union _traceSlotU
+{
+ traceRecordT record;
+ slotWordT words[SLOT_WORDS];
+} traceSlotU;
+
+/****************************************************************************/
+/*                                                                          */
+/*                  PROTOTYPES OF NOT EXPORTED FUNCTIONS                    */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef __GNUC__
+static dword fetch_AndInc(volatile dword* p);
+#endif
+
+/****************************************************************************/
+/*                                                                          */
+/*                  NOT EXPORTED GLOBAL VARIABLES                           */
+/*                                                                          */
+/****************************************************************************/
+
+static traceSlotU Ring[TRACE_RING_SIZE];
+
+/* index + 1 of the event stored in each slot of Ring, 0 while it is written:
+   the reader keeps a slot only if its mark is the one expected before and after the copy */
+static volatile dword Commit[TRACE_RING_SIZE];
+
+/* free running count of events: next one goes to Ring[WriteIndex & RING_MASK] */
+static volatile dword WriteIndex;
+
+static volatile boolean bRecording;
+
+/****************************************************************************/
+/*                                                                          */
+/*                  EXPORTED FUNCTIONS                                      */
+/*                                                                          */
+/****************************************************************************/
+
+/****************************************************************************/
+void traceInit(void)
+/****************************************************************************/
+{
+ dword i;
+
+ bRecording = FALSE;
+ for (i = 0; i < TRACE_RING_SIZE; i++)
+  {
+   Ring[i].record.event = traceNone;
+   Commit[i] = 0;
+  }
+ WriteIndex = 0;
+ bRecording = TRUE;
+}
+
+/****************************************************************************/
+void traceRecord(byte event, byte unit, word arg)
+/****************************************************************************/
+{
+ traceSlotU slot;
+ dword time, index, i;
+
+ if (bRecording == FALSE)
+  {
+   return;
+  }
+ time = TRACE_GET_TIMESTAMP();
+ slot.record.timeLow = (word)time;
+ slot.record.timeHigh = (word)(time >> 16);
+ slot.record.event = event;
+ slot.record.unit = unit;
+ slot.record.arg = arg;
+ index = FETCH_AND_INC(&WriteIndex);
+ STORE_RELAXED(&Commit[index & RING_MASK], 0);    /* a reader of the previous event there drops it */
+ FENCE_RELEASE();
+ for (i = 0; i < SLOT_WORDS; i++)
+  {
+   STORE_RELAXED(&Ring[index & RING_MASK].words[i], slot.words[i]);
+  }
+ STORE(&Commit[index & RING_MASK], index + 1);
+}
+
+/****************************************************************************/
+boolean traceSetRecording(boolean bOn)
+/****************************************************************************/
+{
+ boolean bWasOn = bRecording;
+
+ bRecording = bOn;
+ return bWasOn;
+}
+
+/****************************************************************************/
+dword traceRead(traceRecordT* pRecords, dword maxRecords)
+/****************************************************************************/
+{
+ dword end = LOAD(&WriteIndex);
+ dword index = end < TRACE_RING_SIZE ? 0 : end - TRACE_RING_SIZE;
+ dword n = 0, i;
+ traceSlotU slot;
+
+ if (end - index > maxRecords)
+  {
+   index = end - maxRecords;
+  }
+ for (; index != end; index++)
+  {
+   /* left out: events still being written (by a preempted context) and slots reused during the copy */
+   if (LOAD(&Commit[index & RING_MASK]) != index + 1)
+    {
+     continue;
+    }
+   for (i = 0; i < SLOT_WORDS; i++)
+    {
+     slot.words[i] = LOAD_RELAXED(&Ring[index & RING_MASK].words[i]);
+    }
+   FENCE_ACQUIRE();
+   if (LOAD_RELAXED(&Commit[index & RING_MASK]) == index + 1 && LOAD(&WriteIndex) - index <= TRACE_RING_SIZE)
+    {
+     pRecords[n++] = slot.record;
+    }
+  }
+ return n;
+}
+
+/****************************************************************************/
+dword traceGetCount(void)
+/****************************************************************************/
+{
+ return LOAD(&WriteIndex);
+}
+
+/****************************************************************************/
+/*                                                                          */
+/*                  NOT EXPORTED FUNCTIONS                                  */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef __GNUC__
+/****************************************************************************/
+static dword fetch_AndInc(volatile dword* p)
+/****************************************************************************/
+{
+ dword value;
+
+ TRACE_ENTER_CRITICAL();
+ value = (*p)++;
+ TRACE_EXIT_CRITICAL();
+ return value;
+}
+#endif
@@ -0,0 +1,144 @@
+#ifndef __TRACE_DEFINED__
+#define __TRACE_DEFINED__
+
+/**
+ * \defgroup trace event trace ring
+ * \{
+ * This module records compact binary events in a fixed size ring, always overwriting the oldest ones, so that what
+ * happened just before a problem can be read after the fact (flight recorder). It is meant to be left on in production:
+ * recording an event (#traceRecord) only takes a time stamp, an atomic increment of the write index, one 8-byte store
+ * and the store of a commit mark. It locks nothing, so events can be recorded from interrupts, threads and the main loop
+ * at the same time: #traceRead checks the commit mark of each event before and after copying it\n
+ * Modules record their own events when built with tracing:
+ * - \c gTimer with \c GTIMER_IMPLEMENTS_TRACE: timer started, timed out, callback entered and exited
+ * - \c swUart with \c SWUART_IMPLEMENTS_TRACE: level set by each Tx bit callback and state reached by each Rx one
+ *   (so every bit edge is time stamped), character pushed in or popped from the reception FIFO, FIFO flushed, reception errors
+ *   and frames closed on a silence of the line
+ *
+ * Applications can record their own events from #traceUser up\n
+ * #traceRead copies the ring, oldest event first, to be stored or sent out as is (an array of #traceRecordT, in the
+ * byte order of the target). On the host, \c traceToJson/traceToJson converts such a dump to the JSON trace format of
+ * Chrome (chrome://tracing) and Perfetto (ui.perfetto.dev)
+ * \note time stamps are read by \c TRACE_GET_TIMESTAMP, which may be defined in \c system.h to read any free running
+ * counter. By default, a 16th of the cycle counter on x86 and the virtual counter on ARM64. Only their low 32 bits are
+ * kept: the converter unwraps them as long as no two consecutive events are more than 2^31 counts apart
+ * \note \c TRACE_RING_SIZE (a power of two, 256 by default) sets the number of events kept, 8 bytes each plus a
+ * \c dword of commit mark
+ * \note without \c GCC, the write index is incremented between \c TRACE_ENTER_CRITICAL and \c TRACE_EXIT_CRITICAL,
+ * to be defined in \c system.h when events are recorded from interrupts
+ *
+ * \file trace.h
+ * \brief header of the trace module
+ * \author Gerard Gauthier
+ * \date 2026/10
+ */
+
+/****************************************************************************/
+/*                                                                          */
+/*                  MODULE DEPENDENCY                                       */
+/*                                                                          */
+/****************************************************************************/
+
+#include "terms.h" /* where boolean, dword, word, byte... should be defined as types */
+#include "system.h" /* where TRACE_RING_SIZE and TRACE_GET_TIMESTAMP may be defined */
+
+/****************************************************************************/
+/*                                                                          */
+/*                  DEFINITIONS AND MACROS                                  */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef TRACE_RING_SIZE /* events kept, a power of two */
+ #define TRACE_RING_SIZE (256)
+#endif
+#if (TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) != 0
+ #error TRACE_RING_SIZE should be a power of two
+#endif
+
+#ifndef TRACE_GET_TIMESTAMP /* free running counter, possibly defined in system.h */
+ #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+  #define TRACE_GET_TIMESTAMP() ((dword)(__builtin_ia32_rdtsc() >> 4))
+ #elif defined(__GNUC__) && defined(__aarch64__)
+  #define TRACE_GET_TIMESTAMP() __extension__({ unsigned long long _c; __asm__ volatile("mrs %0, cntvct_el0" : "=r"(_c)); (dword)_c; })
+ #else
+  #error TRACE_GET_TIMESTAMP should be defined for this target to read a free running counter
+ #endif
+#endif
+
+/****************************************************************************/
+/*                                                                          */
+/*                  TYPE DEFINITIONS                                        */
+/*                                                                          */
+/****************************************************************************/
+
+/** \brief what a #traceRecordT records */
+typedef enum _traceEventE
+{
+ traceNone = 0,                /**< slot never written */
+ traceGtimerStart,             /**< timer \c arg started */
+ traceGtimerExpire,            /**< timer \c arg timed out */
+ traceGtimerCallbackEnter,     /**< callback of timer \c arg called */
+ traceGtimerCallbackExit,      /**< callback of timer \c arg returned */
+ traceSwUartTxState,           /**< transmitter \c unit set its line for one bit (\c arg 2 mark, 1 space) or went idle (0) */
+ traceSwUartRxState,           /**< receiver \c unit reached state \c arg & 0xff, on bit \c arg >> 8 */
+ traceSwUartFifoPush,          /**< receiver \c unit stored character \c arg in its FIFO */
+ traceSwUartFifoPop,           /**< character \c arg read from the FIFO of receiver \c unit */
+ traceSwUartFifoFlush,         /**< FIFO of receiver \c unit flushed */
+ traceSwUartError,             /**< receiver \c unit got errors \c arg (bits of #swUartErrorBitDefinitionE) */
+ traceSwUartFifoRead,          /**< \c arg characters read at once from the FIFO of receiver \c unit */
+ traceSwUartFrame,             /**< receiver \c unit closed a frame of \c arg characters (low 16 bits) on a silence */
+ traceUser = 0x80              /**< first event code free for the application */
+} traceEventE;
+
+/** \brief **one event, 8 bytes**
+ *
+ * Made of 16-bit halves so that it has the same layout on every target
+ */
+typedef struct _traceRecordT
+{
+ word timeLow;                 /**< low 16 bits of the time stamp */
+ word timeHigh;                /**< high 16 bits of the time stamp */
+ byte event;                   /**< a #traceEventE */
+ byte unit;                    /**< instance of the module (0 for gTimer, index of transmitter or receiver for swUart) */
+ word arg;                     /**< depends on \c event (timer id for gTimer) */
+} traceRecordT;
+
+/****************************************************************************/
+/*                                                                          */
+/*                  EXPORTED FUNCTIONS                                      */
+/*                                                                          */
+/****************************************************************************/
+
+/** \brief clears the ring and starts recording */
+void traceInit(void);
+
+/** \brief records one event in the ring, overwriting the oldest one if need be
+ *
+ * Does nothing when recording is stopped (see #traceSetRecording)
+ */
+void traceRecord(byte event /**< a #traceEventE */, byte unit /**< module instance */, word arg /**< argument of the event */);
+
+/** \brief starts or stops recording
+ *
+ * Stopping as soon as a problem is detected keeps the events which led to it from being overwritten
+ * \return \c TRUE if recording was on
+ */
+boolean traceSetRecording(boolean bOn /**< \c TRUE to record events */);
+
+/** \brief copies the newest events of the ring, oldest first
+ *
+ * Events overwritten while they are copied (by recordings going on), and events whose recording is not finished
+ * (by a preempted context), are left out
+ * \return number of events copied
+ */
+dword traceRead(traceRecordT* pRecords /**< where to copy events */,
+                dword maxRecords /**< largest number of events to copy */);
+
+/** \brief number of events recorded since #traceInit (kept or not) */
+dword traceGetCount(void);
+
+/**
+ * \}
+ */
+
+#endif /* __TRACE_DEFINED__ */
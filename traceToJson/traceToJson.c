@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**************************************************
+
+file: traceToJson.c
+purpose: converts a dump of the trace ring (what traceRead
+         copied, stored as is from a little-endian target)
+         to the JSON trace format of Chrome (chrome://tracing)
+         and Perfetto (ui.perfetto.dev):
+         - gTimer: one track per timer with its starts and
+           time-outs, and its callbacks as slices
+         - swUart: one track per transmitter and per receiver
+           with the state of each bit as a slice, reception
+           errors, frames closed on a silence, and a counter of
+           characters in each FIFO
+         - application events (traceUser and up) as instants
+usage: traceToJson [-u counts per microsecond] dump [output]
+       (the time stamp unit: 1 by default, with the default
+       TRACE_GET_TIMESTAMP of x86, the clock in MHz / 16)
+
+**************************************************/
+#include "trace.h"
+
+#define MAX_UNITS (0x100)
+
+/* names of states, in the order of swUartTxStateE and swUartRxStateE of swUart.c */
+static const char* const TxStateNames[] = { "idle", "space", "mark" };
+static const char* const RxStateNames[] = { "idle", "start", "bit", "parity", "stop 1", "stop 2" };
+
+/* a swUart state machine as seen so far */
+typedef struct
+{
+ boolean bInState;    /* a state (not idle) is going on */
+ byte state;
+ byte bitPos;
+ double since;        /* time it was reached */
+} stateTrackT;
+
+enum { PID_GTIMER = 1, PID_TX, PID_RX, PID_USER };
+
+static FILE* Out;
+static const char* Separator = "";
+
+static void emit(const char* format, double ts, unsigned pid, unsigned tid)
+{
+ fprintf(Out, "%s\n{\"ts\":%.3f,\"pid\":%u,\"tid\":%u,", Separator, ts, pid, tid);
+ Separator = ",";
+ fputs(format, Out);
+}
+
+static void closeState(stateTrackT* pTrack, const char* const* names, unsigned nbOfNames, double now, unsigned pid,
+                       unsigned tid)
+{
+ if (pTrack->bInState)
+  {
+   emit("", pTrack->since, pid, tid);
+   fprintf(Out, "\"ph\":\"X\",\"dur\":%.3f,\"name\":\"%s\",\"args\":{\"bit\":%u}}",
+           now > pTrack->since ? now - pTrack->since : 0.0,
+           pTrack->state < nbOfNames ? names[pTrack->state] : "?", pTrack->bitPos);
+  }
+ pTrack->bInState = FALSE;
+}
+
+static void nameTrack(unsigned pid, unsigned tid, const char* what, const char* name, unsigned index)
+{
+ fprintf(Out, "%s\n{\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"name\":\"%s\",\"args\":{\"name\":\"%s%u\"}}",
+         Separator, pid, tid, what, name, index);
+ Separator = ",";
+}
+
+int main(int argc, char** argv)
+{
+ static stateTrackT txTracks[MAX_UNITS], rxTracks[MAX_UNITS];
+ static unsigned fifoLevels[MAX_UNITS];
+ static boolean bTxSeen[MAX_UNITS], bRxSeen[MAX_UNITS], bInCallback[0x10000], bTimerSeen[0x10000];
+ double unitsPerUs = 1.0, now = 0.0;
+ unsigned long long time = 0;
+ unsigned long nbOfRecords = 0;
+ unsigned long stamp, last = 0;
+ unsigned char raw[sizeof(traceRecordT)];
+ unsigned event, unit, arg, i;
+ FILE* in;
+
+ if (argc > 2 && strcmp(argv[1], "-u") == 0)
+  {
+   unitsPerUs = atof(argv[2]);
+   argc -= 2;
+   argv += 2;
+  }
+ if (argc < 2 || unitsPerUs <= 0)
+  {
+   fprintf(stderr, "usage: traceToJson [-u counts per microsecond] dump [output]\n");
+   return 1;
+  }
+ if ((in = fopen(argv[1], "rb")) == NULL)
+  {
+   perror(argv[1]);
+   return 1;
+  }
+ Out = argc > 2 ? fopen(argv[2], "w") : stdout;
+ if (Out == NULL)
+  {
+   perror(argv[2]);
+   return 1;
+  }
+ fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", Out);
+ nameTrack(PID_GTIMER, 0, "process_name", "gTimer", 0);
+ nameTrack(PID_TX, 0, "process_name", "swUart Tx", 0);
+ nameTrack(PID_RX, 0, "process_name", "swUart Rx", 0);
+ nameTrack(PID_USER, 0, "process_name", "application", 0);
+ while (fread(raw, sizeof(raw), 1, in) == 1)
+  {
+   stamp = raw[0] | raw[1] << 8 | (unsigned long)raw[2] << 16 | (unsigned long)raw[3] << 24;
+   event = raw[4];
+   unit = raw[5];
+   arg = raw[6] | raw[7] << 8;
+   if (event == traceNone)
+    {
+     continue;
+    }
+   /* 32-bit stamps unwrapped, events being close enough: going back a little happens when recordings interleave */
+   if (nbOfRecords++ == 0)
+    {
+     last = stamp;
+    }
+   if (((stamp - last) & 0xffffffffUL) < 0x80000000UL)
+    {
+     time += (stamp - last) & 0xffffffffUL;
+    }
+   else
+    {
+     time -= (last - stamp) & 0xffffffffUL;
+    }
+   last = stamp;
+   now = (double)(long long)time / unitsPerUs;
+   switch (event)
+    {
+     case traceGtimerStart:
+     case traceGtimerExpire:
+      emit("\"ph\":\"i\",\"s\":\"t\",", now, PID_GTIMER, arg);
+      fprintf(Out, "\"name\":\"%s\"}", event == traceGtimerStart ? "start" : "time-out");
+      bTimerSeen[arg] = TRUE;
+      break;
+     case traceGtimerCallbackEnter:
+      emit("\"ph\":\"B\",\"name\":\"callback\"}", now, PID_GTIMER, arg);
+      bInCallback[arg] = bTimerSeen[arg] = TRUE;
+      break;
+     case traceGtimerCallbackExit:
+      if (bInCallback[arg])   /* the dump may begin within a callback */
+       {
+        emit("\"ph\":\"E\"}", now, PID_GTIMER, arg);
+        bInCallback[arg] = FALSE;
+       }
+      break;
+     case traceSwUartTxState:
+     case traceSwUartRxState:
+      {
+       boolean bTx = event == traceSwUartTxState;
+       stateTrackT* pTrack = (bTx ? txTracks : rxTracks) + unit;
+
+       closeState(pTrack, bTx ? TxStateNames : RxStateNames,
+                  bTx ? sizeof(TxStateNames) / sizeof(*TxStateNames) : sizeof(RxStateNames) / sizeof(*RxStateNames),
+                  now, bTx ? PID_TX : PID_RX, unit);
+       pTrack->state = (byte)arg;
+       pTrack->bitPos = (byte)(arg >> 8);
+       pTrack->since = now;
+       pTrack->bInState = pTrack->state != 0;    /* idle is first of both */
+       (bTx ? bTxSeen : bRxSeen)[unit] = TRUE;
+      }
+      break;
+     case traceSwUartFifoPush:
+     case traceSwUartFifoPop:
+     case traceSwUartFifoFlush:
+     case traceSwUartFifoRead:
+      if (event == traceSwUartFifoPush)
+       {
+        fifoLevels[unit]++;
+       }
+      else if (event == traceSwUartFifoPop && fifoLevels[unit] > 0)   /* pops of what was pushed before the dump are lost */
+       {
+        fifoLevels[unit]--;
+       }
+      else if (event == traceSwUartFifoRead && fifoLevels[unit] > arg)
+       {
+        fifoLevels[unit] -= arg;
+       }
+      else
+       {
+        fifoLevels[unit] = 0;
+       }
+      emit("\"ph\":\"C\",", now, PID_RX, unit);
+      fprintf(Out, "\"name\":\"FIFO %u\",\"args\":{\"chars\":%u}}", unit, fifoLevels[unit]);
+      bRxSeen[unit] = TRUE;
+      break;
+     case traceSwUartFrame:
+      emit("\"ph\":\"i\",\"s\":\"t\",", now, PID_RX, unit);
+      fprintf(Out, "\"name\":\"frame\",\"args\":{\"chars\":%u}}", arg);
+      bRxSeen[unit] = TRUE;
+      break;
+     case traceSwUartError:
+      emit("\"ph\":\"i\",\"s\":\"t\",", now, PID_RX, unit);
+      fprintf(Out, "\"name\":\"%s error\"}",
+              arg & 1 << 0 ? "framing" : arg & 1 << 1 ? "parity" : arg & 1 << 2 ? "overrun" : "unknown");
+      bRxSeen[unit] = TRUE;
+      break;
+     default:
+      emit("\"ph\":\"i\",\"s\":\"t\",", now, PID_USER, unit);
+      fprintf(Out, "\"name\":\"event %u\",\"args\":{\"arg\":%u}}", event, arg);
+      break;
+    }
+  }
+ for (i = 0; i < MAX_UNITS; i++)
+  {
+   closeState(&txTracks[i], TxStateNames, sizeof(TxStateNames) / sizeof(*TxStateNames), now, PID_TX, i);
+   closeState(&rxTracks[i], RxStateNames, sizeof(RxStateNames) / sizeof(*RxStateNames), now, PID_RX, i);
+   if (bTxSeen[i])
+    {
+     nameTrack(PID_TX, i, "thread_name", "Tx ", i);
+    }
+   if (bRxSeen[i])
+    {
+     nameTrack(PID_RX, i, "thread_name", "Rx ", i);
+    }
+  }
+ for (i = 0; i < 0x10000; i++)
+  {
+   if (bTimerSeen[i])
+    {
+     nameTrack(PID_GTIMER, i, "thread_name", "timer ", i);
+    }
+  }
+ fputs("\n]}\n", Out);
+ fprintf(stderr, "%lu events over %.3f us\n", nbOfRecords, now);
+ fclose(in);
+ return Out != stdout && fclose(Out) != 0;
+}